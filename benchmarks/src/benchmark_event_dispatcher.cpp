@@ -1,51 +1,400 @@
 #include "benchmark_event_dispatcher.hpp"
 #include <benchmark/benchmark.h>
+#include <algorithm>
 #include <chrono>
-#include <iostream>
+#include <cstdint>
+#include <string>
 #include <thread>
+#include <vector>
 
 namespace evds::benchmarks
 {
 using evds_benchmarks = evds::benchmarks::event_dispatcher_benchmark;
 
+constexpr evds::event_key<int> event_1{"Event_1"};
+constexpr int events_per_iteration = 1000;
+constexpr int producer_events = 10000;
+
+inline auto now_ns() -> std::int64_t
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline void wait_calls(const std::atomic<std::int64_t>& calls, std::int64_t expected_calls)
+{
+    while (calls.load(std::memory_order_acquire) < expected_calls)
+        std::this_thread::yield();
+}
+
+inline void report_percentiles(benchmark::State& state, std::vector<std::int64_t>& samples_ns)
+{
+    if (samples_ns.empty())
+        return;
+
+    std::sort(samples_ns.begin(), samples_ns.end());
+    const auto percentile = [&samples_ns](double p)
+    {
+        const auto index = std::min(samples_ns.size() - 1, static_cast<std::size_t>(p * static_cast<double>(samples_ns.size())));
+        return static_cast<double>(samples_ns[index]) / 1000.0;
+    };
+
+    state.counters["p50_us"] = percentile(0.5);
+    state.counters["p99_us"] = percentile(0.99);
+    state.counters["p999_us"] = percentile(0.999);
+}
+
+// Sustained throughput with empty handlers: every iteration emits a burst of events and waits for all handler calls.
 // NOLINTNEXTLINE
 BENCHMARK_DEFINE_F(evds_benchmarks, one_event_N_handlers)(benchmark::State& state)
 {
-    constexpr auto event_name = "Event_1";
+    const auto threads_count = static_cast<unsigned int>(state.range(0));
+    const auto handlers_count = state.range(1);
+
+    std::atomic<std::int64_t> calls = 0;
+    for (auto i = 0; i < handlers_count; ++i)
+        e->add_handler(event_1, [&calls](int){ calls.fetch_add(1, std::memory_order_release); });
+    e->start(threads_count);
 
+    std::int64_t expected_calls = 0;
+    const auto allocations_before = allocations_count.load();
     for (auto _ : state)
     {
-        state.PauseTiming();
-        
-        const auto threads_count = state.range(0);
-        const auto handlers_count = state.range(1);
-        
-        e->start(threads_count);
-        unsigned int call_counter = 0;
-        
-        for(auto i = 0; i < handlers_count; ++i)
+        for (auto i = 0; i < events_per_iteration; ++i)
+            e->emit(event_1, i);
+
+        expected_calls += events_per_iteration * handlers_count;
+        wait_calls(calls, expected_calls);
+    }
+
+    const auto allocations = allocations_count.load() - allocations_before;
+    state.SetItemsProcessed(state.iterations() * events_per_iteration);
+    state.counters["handler_calls_per_second"] = benchmark::Counter(static_cast<double>(expected_calls), benchmark::Counter::kIsRate);
+    state.counters["allocs_per_emit"] = benchmark::Counter(static_cast<double>(allocations) / static_cast<double>(state.iterations() * events_per_iteration));
+}
+
+// NOLINTNEXTLINE
+BENCHMARK_REGISTER_F(evds_benchmarks, one_event_N_handlers)
+    ->ArgsProduct({{1, 2, 4}, {1, 5, 20}})
+    ->ArgNames({"dispatcher_threads", "dispatcher_handlers"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond)
+    ;
+
+// Producers run on their own threads, started for each iteration: every producer emits producer_events events.
+template <typename QueuePolicy>
+void multi_producer_contention(benchmark::State& state)
+{
+    const auto producers_count = state.range(0);
+    const auto threads_count = static_cast<unsigned int>(state.range(1));
+
+    evds::basic_event_dispatcher<QueuePolicy> e;
+    std::atomic<std::int64_t> calls = 0;
+    e.add_handler(event_1, [&calls](int){ calls.fetch_add(1, std::memory_order_release); });
+    e.start(threads_count);
+
+    std::int64_t expected_calls = 0;
+    for (auto _ : state)
+    {
+        std::vector<std::thread> producers;
+        for (auto p = 0; p < producers_count; ++p)
         {
-            e->add_handler<std::string>(event_name, [&call_counter](const std::string& s){
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                ++call_counter;
+            producers.emplace_back([&e]
+            {
+                for (auto i = 0; i < producer_events; ++i)
+                    e.emit(event_1, i);
             });
         }
 
-        state.ResumeTiming();
-        bool is_call_scheduled = e->emit(event_name, std::string("THE EVENT PAYLOAD!"));
-        benchmark::DoNotOptimize(is_call_scheduled);
+        for (auto&& producer : producers)
+            producer.join();
+
+        expected_calls += producers_count * producer_events;
+        wait_calls(calls, expected_calls);
     }
+
+    state.SetItemsProcessed(expected_calls);
+    e.stop();
 }
 
 // NOLINTNEXTLINE
-BENCHMARK_REGISTER_F(evds_benchmarks, one_event_N_handlers)
-    ->ArgsProduct({{1,2,3,4},{5,10,15,20}})
-    // ->ThreadRange(1, 8)
-    ->Threads(1)
-    ->ArgNames({"dispatcher_threads", "dispatcher_handlers"})
+BENCHMARK_TEMPLATE(multi_producer_contention, evds::queue_policy::mutex)
+    ->ArgsProduct({{1, 2, 4, 8}, {1, 2, 4}})
+    ->ArgNames({"producers", "dispatcher_threads"})
+    ->UseRealTime()
+    ;
+
+// NOLINTNEXTLINE
+BENCHMARK_TEMPLATE(multi_producer_contention, evds::queue_policy::lock_free<4096>)
+    ->ArgsProduct({{1, 2, 4, 8}, {1, 2, 4}})
+    ->ArgNames({"producers", "dispatcher_threads"})
+    ->UseRealTime()
+    ;
+
+// NOLINTNEXTLINE
+BENCHMARK_TEMPLATE(multi_producer_contention, evds::queue_policy::work_stealing)
+    ->ArgsProduct({{1, 2, 4, 8}, {1, 2, 4}})
+    ->ArgNames({"producers", "dispatcher_threads"})
+    ->UseRealTime()
+    ;
+
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(evds_benchmarks, payload_size)(benchmark::State& state)
+{
+    const evds::event_key<std::string> event_name{"Event_String"};
+    const std::string payload(static_cast<std::size_t>(state.range(0)), 'x');
+
+    std::atomic<std::int64_t> calls = 0;
+    e->add_handler(event_name, [&calls](const std::string& s)
+    {
+        benchmark::DoNotOptimize(s.data());
+        calls.fetch_add(1, std::memory_order_release);
+    });
+    e->start(1);
+
+    std::int64_t expected_calls = 0;
+    const auto allocations_before = allocations_count.load();
+    for (auto _ : state)
+    {
+        for (auto i = 0; i < events_per_iteration; ++i)
+            e->emit(event_name, payload);
+
+        expected_calls += events_per_iteration;
+        wait_calls(calls, expected_calls);
+    }
+
+    const auto allocations = allocations_count.load() - allocations_before;
+    state.SetItemsProcessed(expected_calls);
+    state.SetBytesProcessed(expected_calls * state.range(0));
+    state.counters["allocs_per_emit"] = benchmark::Counter(static_cast<double>(allocations) / static_cast<double>(expected_calls));
+}
+
+// NOLINTNEXTLINE
+BENCHMARK_REGISTER_F(evds_benchmarks, payload_size)
+    ->RangeMultiplier(4)
+    ->Range(8, 8 << 10)
+    ->ArgNames({"payload_bytes"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond)
+    ;
+
+// Emit throughput while another thread keeps adding and removing handlers of the same event.
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(evds_benchmarks, add_remove_churn)(benchmark::State& state)
+{
+    const bool is_churning = state.range(0) != 0;
+
+    std::atomic<std::int64_t> calls = 0;
+    e->add_handler(event_1, [&calls](int){ calls.fetch_add(1, std::memory_order_release); });
+    e->start(1);
+
+    std::atomic_bool is_done = false;
+    std::atomic<std::int64_t> churn_count = 0;
+    std::thread churn;
+    if (is_churning)
+    {
+        churn = std::thread([this, &is_done, &churn_count]
+        {
+            while (!is_done)
+            {
+                e->remove_handler(e->add_handler(event_1, [](int i){ benchmark::DoNotOptimize(i); }));
+                churn_count.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    std::int64_t expected_calls = 0;
+    for (auto _ : state)
+    {
+        for (auto i = 0; i < events_per_iteration; ++i)
+            e->emit(event_1, i);
+
+        expected_calls += events_per_iteration;
+        wait_calls(calls, expected_calls);
+    }
+
+    is_done = true;
+    if (churn.joinable())
+        churn.join();
+
+    state.SetItemsProcessed(expected_calls);
+    state.counters["add_remove_per_second"] = benchmark::Counter(static_cast<double>(churn_count.load()), benchmark::Counter::kIsRate);
+}
+
+// NOLINTNEXTLINE
+BENCHMARK_REGISTER_F(evds_benchmarks, add_remove_churn)
+    ->Arg(0)
+    ->Arg(1)
+    ->ArgNames({"churn"})
     ->UseRealTime()
-    ->ReportAggregatesOnly(false)
-    ->DisplayAggregatesOnly(false)
+    ->Unit(benchmark::kMicrosecond)
     ;
     
-}
\ No newline at end of file
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(evds_benchmarks, one_event_N_handlers_dispatch_mode)(benchmark::State& state)
+{
+    constexpr auto event_name = "Event_1";
+    const auto mode = static_cast<evds::dispatch_mode>(state.range(0));
+    const auto handlers_count = state.range(1);
+
+    evds::event_options event_options;
+    event_options.dispatch = mode;
+    event_options.chunk_size = 4;
+    e->configure_event<std::string>(event_name, event_options);
+    for(auto i = 0; i < handlers_count; ++i)
+        e->add_handler<std::string>(event_name, [](const std::string& s){ benchmark::DoNotOptimize(s.size()); });
+    e->start(1);
+
+    const std::string payload(64, 'x');
+    const auto allocations_before = allocations_count.load();
+    for (auto _ : state)
+    {
+        bool is_call_scheduled = e->emit(event_name, payload);
+        benchmark::DoNotOptimize(is_call_scheduled);
+    }
+
+    const auto allocations = allocations_count.load() - allocations_before;
+    state.counters["allocs_per_emit"] = benchmark::Counter(static_cast<double>(allocations) / state.iterations());
+}
+
+// NOLINTNEXTLINE
+BENCHMARK_REGISTER_F(evds_benchmarks, one_event_N_handlers_dispatch_mode)
+    ->ArgsProduct({{
+        static_cast<int>(evds::dispatch_mode::per_handler), 
+        static_cast<int>(evds::dispatch_mode::fan_out), 
+        static_cast<int>(evds::dispatch_mode::chunked)}, 
+        {1, 5, 20}})
+    ->ArgNames({"dispatch_mode", "dispatcher_handlers"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond)
+    ;
+
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(evds_benchmarks, one_event_small_payload_allocations)(benchmark::State& state)
+{
+    constexpr auto event_name = "Event_1";
+    const auto mode = static_cast<evds::dispatch_mode>(state.range(0));
+    const auto handlers_count = state.range(1);
+
+    evds::event_options event_options;
+    event_options.dispatch = mode;
+    event_options.chunk_size = 4;
+    e->configure_event<int, double>(event_name, event_options);
+    for(auto i = 0; i < handlers_count; ++i)
+        e->add_handler<int, double>(event_name, [](int i, double d){ benchmark::DoNotOptimize(i + d); });
+    e->start(1);
+
+    // Warm up the task pool and the queue buffer
+    for (auto i = 0; i < 1000; ++i)
+        e->emit(event_name, i, 1.0);
+
+    const auto allocations_before = allocations_count.load();
+    for (auto _ : state)
+    {
+        bool is_call_scheduled = e->emit(event_name, 1, 1.0);
+        benchmark::DoNotOptimize(is_call_scheduled);
+    }
+
+    const auto allocations = allocations_count.load() - allocations_before;
+    state.counters["allocs_per_emit"] = benchmark::Counter(static_cast<double>(allocations) / state.iterations());
+}
+
+// NOLINTNEXTLINE
+BENCHMARK_REGISTER_F(evds_benchmarks, one_event_small_payload_allocations)
+    ->ArgsProduct({{
+        static_cast<int>(evds::dispatch_mode::per_handler), 
+        static_cast<int>(evds::dispatch_mode::fan_out), 
+        static_cast<int>(evds::dispatch_mode::chunked)}, 
+        {1, 5, 20}})
+    ->ArgNames({"dispatch_mode", "dispatcher_handlers"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond)
+    ;
+
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(evds_benchmarks, high_priority_latency_under_load)(benchmark::State& state)
+{
+    const auto scheduling = static_cast<evds::lane_scheduling>(state.range(0));
+    const auto backlog = state.range(1);
+    evds::dispatcher_options options;
+    options.scheduling = scheduling;
+    e = std::make_unique<evds::event_dispatcher>(options);
+
+    std::atomic_bool is_handled = false;
+    evds::event_options event_options;
+    event_options.priority = evds::event_priority::high;
+    e->configure_event<>("Heartbeat", event_options);
+    e->add_handler<>("Heartbeat", [&is_handled](){ is_handled = true; });
+    e->add_handler<int>("Telemetry", [](int i){ benchmark::DoNotOptimize(i); });
+    e->start(1);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (auto i = 0; i < backlog; ++i)
+            e->emit(evds::event_priority::low, "Telemetry", static_cast<int>(i));
+        is_handled = false;
+        state.ResumeTiming();
+
+        e->emit("Heartbeat");
+        while (!is_handled)
+            std::this_thread::yield();
+    }
+
+    state.counters["low_lane_depth"] = benchmark::Counter(static_cast<double>(e->queue_depth(evds::event_priority::low)));
+}
+
+// NOLINTNEXTLINE
+BENCHMARK_REGISTER_F(evds_benchmarks, high_priority_latency_under_load)
+    ->ArgsProduct({{
+        static_cast<int>(evds::lane_scheduling::strict), 
+        static_cast<int>(evds::lane_scheduling::weighted)}, 
+        {0, 1000}})
+    ->ArgNames({"lane_scheduling", "low_priority_backlog"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond)
+    ;
+
+// Emit to handler start latency, one event in flight at a time. Percentiles are reported in microseconds.
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(evds_benchmarks, emit_to_handler_latency)(benchmark::State& state)
+{
+    const auto wait = static_cast<evds::wait_strategy>(state.range(0));
+    const auto threads_count = static_cast<unsigned int>(state.range(1));
+    const evds::event_key<std::int64_t> event_name{"Event_Timestamp"};
+
+    std::atomic<std::int64_t> latency = -1;
+    e->add_handler(event_name, [&latency](std::int64_t emitted){ latency.store(now_ns() - emitted, std::memory_order_release); });
+    evds::start_options options;
+    options.threads = threads_count;
+    options.wait = wait;
+    e->start(options);
+
+    std::vector<std::int64_t> samples;
+    samples.reserve(1 << 16);
+    for (auto _ : state)
+    {
+        latency.store(-1, std::memory_order_relaxed);
+        e->emit(event_name, now_ns());
+
+        std::int64_t sample = -1;
+        while ((sample = latency.load(std::memory_order_acquire)) < 0)
+            std::this_thread::yield();
+        samples.push_back(sample);
+    }
+
+    report_percentiles(state, samples);
+}
+
+// NOLINTNEXTLINE
+BENCHMARK_REGISTER_F(evds_benchmarks, emit_to_handler_latency)
+    ->ArgsProduct({{
+        static_cast<int>(evds::wait_strategy::blocking),
+        static_cast<int>(evds::wait_strategy::spin_then_park),
+        static_cast<int>(evds::wait_strategy::busy_poll)},
+        {1, 4}})
+    ->ArgNames({"wait_strategy", "dispatcher_threads"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond)
+    ;
+
+}
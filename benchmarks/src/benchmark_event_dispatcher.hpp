@@ -2,9 +2,14 @@
 
 #include <benchmark/benchmark.h>
 #include <evds/event_dispatcher.hpp>
+#include <atomic>
+#include <cstddef>
 
 namespace evds::benchmarks
 {
+// Incremented by the global operator new replacement in main.cpp.
+inline std::atomic<std::size_t> allocations_count = 0;
+
 class event_dispatcher_benchmark : public benchmark::Fixture
 {
 public:
@@ -1,7 +1,100 @@
+#include "benchmark_event_dispatcher.hpp"
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
 
+// Every allocation is counted: plain, nothrow and over-aligned ones (cache line aligned members of the dispatcher).
+// Array forms call these by default.
+namespace
+{
+auto counted_malloc(std::size_t size) noexcept -> void*
+{
+    evds::benchmarks::allocations_count.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+auto counted_aligned_malloc(std::size_t size, std::align_val_t alignment) noexcept -> void*
+{
+    evds::benchmarks::allocations_count.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+#if defined(_MSC_VER)
+    return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    // aligned_alloc() wants a size multiple of the alignment.
+    return std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align);
+#endif
+}
+
+void aligned_free(void* ptr) noexcept
+{
+#if defined(_MSC_VER)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+}
+
+auto operator new(std::size_t size) -> void*
+{
+    if (void* ptr = counted_malloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+auto operator new(std::size_t size, const std::nothrow_t&) noexcept -> void*
+{
+    return counted_malloc(size);
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment) -> void*
+{
+    if (void* ptr = counted_aligned_malloc(size, alignment))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept -> void*
+{
+    return counted_aligned_malloc(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
+
+// Results are also written as JSON to evds_benchmarks.json, unless --benchmark_out is given.
 auto main(int argc, char** argv) -> int
 {
+    std::vector<char*> args(argv, argv + argc);
+    std::string out_arg = "--benchmark_out=evds_benchmarks.json";
+    std::string out_format_arg = "--benchmark_out_format=json";
+    if (std::none_of(args.begin(), args.end(), [](const char* arg){ return std::string_view{arg}.starts_with("--benchmark_out="); }))
+        args.insert(std::next(args.begin()), {out_arg.data(), out_format_arg.data()});
+
+    argc = static_cast<int>(args.size());
+    argv = args.data();
     benchmark::Initialize(&argc, argv);
     if (benchmark::ReportUnrecognizedArguments(argc, argv))
         return 1;
@@ -106,7 +106,25 @@ int main()
     e.add_handler<std::string>("Event_H", std::move(class_method_t_bind));
     e.emit("Event_H", std::string("payload"));
 
-    std::this_thread::sleep_for(2s);
+    // Compile-time event keys: no string hashing or allocation on emit
+    constexpr evds::event_key<std::string> event_i("Event_I");
+    e.add_handler(event_i, [](const std::string& arg){ spdlog::info("Compile-time key: {}", arg); });
+    e.emit(event_i, "payload");
+    e.emit<"Event_I">(std::string("payload"));
+
+    // Pre-resolved event handle: emit skips name hashing and handlers table lookup
+    auto event_j = e.register_event<int>("Event_J");
+    e.add_handler<int>("Event_J", [](int arg){ spdlog::info("Event handle: {}", arg); });
+    event_j.emit(42);
+
+    // Synchronous dispatch: inline-safe handlers run right away on the emitting thread
+    evds::handler_options handler_options;
+    handler_options.inline_safe = true;
+    e.add_handler<int>("Event_K", [](int arg){ spdlog::info("Inline handler: {}", arg); }, handler_options);
+    e.emit_sync("Event_K", 7);
+
+    // Graceful shutdown: queued events are handled before the dispatcher threads exit
+    e.stop(evds::drain_policy::drain, 2s);
     spdlog::info("FINISH!");
 
     return 0;
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace evds
+{
+// Coroutine returned by asynchronous handlers. It starts when the handler is called, on the dispatcher thread,
+// and holds no thread while it is suspended. Tasks can co_await other tasks: exceptions propagate to the awaiter.
+// Handler arguments must be taken by value (add_handler() checks it): references into the event payload do not outlive
+// the first suspension.
+class task
+{
+public:
+    struct promise_type
+    {
+        // Resumes the awaiting task, if any. Started tasks own themselves and are destroyed here.
+        struct final_awaiter
+        {
+            auto await_ready() const noexcept -> bool
+            {
+                return false;
+            }
+
+            auto await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept -> std::coroutine_handle<>
+            {
+                auto& promise = coroutine.promise();
+                if (promise.continuation)
+                    return promise.continuation;
+
+                if (promise.is_detached)
+                {
+                    if (promise.exception)
+                        std::terminate();
+                    coroutine.destroy();
+                }
+                return std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        auto get_return_object() noexcept -> task
+        {
+            return task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        auto initial_suspend() const noexcept -> std::suspend_always
+        {
+            return {};
+        }
+
+        auto final_suspend() const noexcept -> final_awaiter
+        {
+            return {};
+        }
+
+        void return_void() const noexcept {}
+
+        void unhandled_exception() noexcept
+        {
+            exception = std::current_exception();
+        }
+
+        std::coroutine_handle<> continuation;
+        promise_type* parent = nullptr; // promise of the continuation, when it is a task too
+        std::exception_ptr exception;
+        bool is_detached = false;
+    };
+
+    task(task&& other) noexcept : _coroutine{std::exchange(other._coroutine, {})} {}
+
+    task& operator=(task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (_coroutine)
+                _coroutine.destroy();
+            _coroutine = std::exchange(other._coroutine, {});
+        }
+        return *this;
+    }
+
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+
+    ~task()
+    {
+        if (_coroutine)
+            _coroutine.destroy();
+    }
+
+    // Runs the task up to its first suspension. It then owns itself: an exception escaping from it terminates the program.
+    void start() &&
+    {
+        auto coroutine = std::exchange(_coroutine, {});
+        coroutine.promise().is_detached = true;
+        coroutine.resume();
+    }
+
+    auto operator co_await() const noexcept
+    {
+        return awaiter{_coroutine};
+    }
+
+private:
+    struct awaiter
+    {
+        auto await_ready() const noexcept -> bool
+        {
+            return !coroutine || coroutine.done();
+        }
+
+        template <typename PromiseT>
+        auto await_suspend(std::coroutine_handle<PromiseT> continuation) noexcept -> std::coroutine_handle<>
+        {
+            coroutine.promise().continuation = continuation;
+            if constexpr (std::is_same_v<PromiseT, promise_type>)
+                coroutine.promise().parent = &continuation.promise();
+            return coroutine;
+        }
+
+        void await_resume() const
+        {
+            if (coroutine && coroutine.promise().exception)
+                std::rethrow_exception(coroutine.promise().exception);
+        }
+
+        std::coroutine_handle<promise_type> coroutine;
+    };
+
+    explicit task(std::coroutine_handle<promise_type> coroutine) noexcept : _coroutine{coroutine} {}
+
+    std::coroutine_handle<promise_type> _coroutine;
+};
+
+}
+
+namespace evds::details
+{
+// What co_await on an event gives back: nothing, its only argument, or a tuple of its arguments.
+template <typename... Args>
+struct awaited_event
+{
+    using type = std::tuple<Args...>;
+};
+
+template <>
+struct awaited_event<>
+{
+    using type = void;
+};
+
+template <typename T>
+struct awaited_event<T>
+{
+    using type = T;
+};
+
+template <typename... Args>
+using awaited_event_t = typename awaited_event<Args...>::type;
+
+// Frame that owns a suspended coroutine: the started task at the root of the tasks awaiting it.
+// Destroying it destroys the whole chain. Null when no started task owns it, e.g. another kind of coroutine awaits it.
+template <typename PromiseT>
+auto owning_frame(std::coroutine_handle<PromiseT> coroutine) noexcept -> std::coroutine_handle<>
+{
+    if constexpr (std::is_same_v<PromiseT, task::promise_type>)
+    {
+        auto* promise = &coroutine.promise();
+        while (promise->parent)
+            promise = promise->parent;
+        if (promise->is_detached)
+            return std::coroutine_handle<task::promise_type>::from_promise(*promise);
+    }
+    return {};
+}
+
+}
@@ -1,28 +1,64 @@
 #pragma once 
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <fstream>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <optional>
+#include <shared_mutex>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <tuple>
 #include <barrier>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include <evds/coroutine.hpp>
+#include <evds/event_key.hpp>
+#include <evds/event_options.hpp>
+#include <evds/event_queue.hpp>
+#include <evds/executor.hpp>
 #include <evds/function_traits.hpp>
+#include <evds/payload.hpp>
+#include <evds/rcu.hpp>
+#include <evds/stats.hpp>
+#include <evds/task.hpp>
+#include <evds/timer_wheel.hpp>
+#include <evds/trace.hpp>
+#include <evds/thread_placement.hpp>
 
 namespace evds
 {
-class event_dispatcher final
+template <typename QueuePolicy = queue_policy::mutex, std::size_t TaskSize = 48>
+class basic_event_dispatcher final
 {
 private:
-    using event_t = std::function<void()>;
+    using event_t = details::inline_task<TaskSize>;
+
+    static constexpr std::size_t strand_stripes_count = 64;
+    static constexpr auto not_overloaded = std::chrono::steady_clock::time_point::max();
+    static constexpr std::size_t strand_drain_budget = 16;
+    static constexpr std::chrono::milliseconds timer_resolution{1};
+    static constexpr std::size_t executor_drain_budget = 64;
+    static constexpr std::uint8_t internal_task = 0; // tag of strand drains, coroutine resumes and conflation flushes
 
     struct base_handler_t
     {
-        base_handler_t(unsigned long id) noexcept : id{id} {}
+        base_handler_t(unsigned long id, const handler_options& options) noexcept : id{id}, inline_safe{options.inline_safe} {}
         virtual ~base_handler_t() noexcept {}
         base_handler_t(const base_handler_t&) = delete;
         base_handler_t(base_handler_t&&) noexcept = delete;
@@ -30,210 +66,2430 @@ private:
         base_handler_t& operator=(base_handler_t&&) = delete;
 
         const unsigned long id;
+        const bool inline_safe;
+        std::atomic_bool removed{false};
     };
 
     template <typename... Args>
     class handler_t : public base_handler_t
     {
     public:
-        handler_t(unsigned long id, std::function<void(Args...)>&& h) noexcept : base_handler_t(id), _handler{std::move(h)} {}
+        handler_t(unsigned long id, const handler_options& options, std::function<void(const Args&...)>&& h) noexcept 
+            : base_handler_t(id, options), _handler{std::move(h)} {}
         ~handler_t() noexcept override = default;
         handler_t(const handler_t&) = delete;
         handler_t(handler_t&&) noexcept = delete;
         handler_t& operator=(const handler_t&) = delete;
         handler_t& operator=(handler_t&&) = delete;
         
-        void call(Args... args) const
+        // Snapshots taken before remove_handler() may still list the handler: it is skipped from then on.
+        void call(const Args&... args) const
         {
-            _handler(std::forward<Args>(args)...);
+            if (!this->removed.load(std::memory_order_acquire))
+                _handler(args...);
         }
 
     private:
-        std::function<void(Args...)> _handler;
+        std::function<void(const Args&...)> _handler;
     };
 
-public:
-    event_dispatcher() noexcept : _is_running{false}
+    using handlers_t = std::vector<std::shared_ptr<base_handler_t>>;
+
+    struct conflation_slot_t;
+
+    // What an emit needs to know about an event: handlers are copy-on-write, so taking a snapshot costs
+    // one reference count whatever the number of handlers. That reference then moves into the emit payload.
+    struct event_snapshot_t
     {
-    }
+        std::shared_ptr<const handlers_t> handlers;
+        event_options options;
+        std::optional<std::uint64_t> strand; // key of the strand of ordered events
+        conflation_slot_t* conflation = nullptr; // conflated events only
+#if defined(EVDS_ENABLE_STATS)
+        details::event_counters* counters = nullptr;
+#endif
+#if defined(EVDS_ENABLE_TRACING)
+        event_id_t id = 0;
+#endif
+    };
 
-    ~event_dispatcher() noexcept
+    // What a channel publishes: emit_sync() also uses the inline/queued split of the handlers, computed once when they change.
+    // Null inline handlers mean there are none: queued_event is then unused.
+    struct published_event_t
     {
-        stop();
-        handler_id = 0;
-    }
+        event_snapshot_t event;
+        event_snapshot_t queued_event;
+        std::shared_ptr<const handlers_t> inline_handlers;
+    };
 
-    event_dispatcher(const event_dispatcher&) = delete;
-    event_dispatcher(event_dispatcher&&) noexcept = delete;
-    event_dispatcher& operator=(const event_dispatcher&) = delete;
-    event_dispatcher& operator=(event_dispatcher&&) = delete;
+    // What emit_sync() takes out of the published event.
+    struct sync_event_t
+    {
+        event_snapshot_t queued_event;
+        std::shared_ptr<const handlers_t> inline_handlers;
+    };
 
-    template <typename... Args>
-    constexpr auto get_event_handler_id(std::string&& event_name) const
+    // Where the tasks of an emit go: a priority lane, through the strand of a key when ordered.
+    struct route_t
     {
-        if constexpr(sizeof...(Args) == 0)
+        event_priority priority;
+        std::optional<std::uint64_t> strand;
+    };
+
+    // Newest payload of a conflated event. At most one flush task per event is queued: it runs the handlers
+    // on the payload found when it is picked up, so emits made meanwhile only replace that payload.
+    struct conflation_slot_t
+    {
+        // Called by the flush task, or when it is dropped unrun: the next emit queues a new one.
+        auto take() -> std::shared_ptr<const void>
         {
-            return std::move(event_name);
+            std::scoped_lock slot_lock(mutex);
+            is_queued = false;
+            return std::move(payload);
         }
-        else
+
+        std::mutex mutex;
+        std::shared_ptr<const void> payload;
+        route_t route{event_priority::normal, std::nullopt}; // of the newest emit
+        bool is_queued = false;
+        std::uint64_t timer_id = 0;  // running debounce or throttle window
+        std::uint64_t window_id = 0; // tells the running window from cancelled ones
+    };
+
+    // Tasks of a strand run one at a time, in push order. A strand only exists while it has tasks: the first one
+    // creates it and queues its drain task, which erases it once empty. Each key gets a strand of its own.
+    struct strand_t
+    {
+        details::circular_buffer<event_t> tasks;
+    };
+
+    using strands_t = std::unordered_map<std::uint64_t, strand_t>;
+
+    // Keys sharing a stripe only share its lock: their strands still run in parallel.
+    // The node of the last erased strand is kept for the next one, along with its tasks storage.
+    struct alignas(details::cache_line_size) strands_stripe_t
+    {
+        std::mutex mutex;
+        strands_t strands;
+        typename strands_t::node_type spare;
+    };
+
+    // Entries are never erased from the channels table, so event handles can keep pointing at them.
+    // The published snapshot is immutable: writers swap in a new one and retire the old one through the rcu domain.
+    class event_channel_t
+    {
+    public:
+        event_channel_t(event_id_t id, std::string_view name, std::string_view signature) 
+            : id{id}, name{name}, signature{signature}, _snapshot{new published_event_t{}} {}
+
+        ~event_channel_t()
         {
-            auto args_hash = std::to_string((typeid(std::decay_t<Args>).hash_code() + ... ));
-            return std::move(event_name + args_hash);
+            delete _snapshot.load(std::memory_order_relaxed);
         }
-    }
 
-    template <typename... Args, typename HandlerT>
-    auto add_handler(std::string event_name, HandlerT&& event_handler) -> unsigned long
+        event_channel_t(const event_channel_t&) = delete;
+        event_channel_t(event_channel_t&&) noexcept = delete;
+        event_channel_t& operator=(const event_channel_t&) = delete;
+        event_channel_t& operator=(event_channel_t&&) = delete;
+
+        // Requires an rcu read section: the reference is only valid inside it.
+        auto snapshot() const -> const published_event_t&
+        {
+            return *_snapshot.load(std::memory_order_seq_cst);
+        }
+
+        // Requires _handlers_mutex.
+        auto current() const -> const published_event_t&
+        {
+            return *_snapshot.load(std::memory_order_relaxed);
+        }
+
+        // Requires _handlers_mutex. The previous snapshot may only be released after an rcu synchronize().
+        auto exchange(published_event_t snapshot) -> std::unique_ptr<const published_event_t>
+        {
+            return std::unique_ptr<const published_event_t>{_snapshot.exchange(new published_event_t{std::move(snapshot)}, std::memory_order_seq_cst)};
+        }
+
+        const event_id_t id;
+        const std::string name;
+        const std::string signature; // ids are hashes: the name and signature tell colliding events apart
+        std::size_t tombstones = 0; // removed handlers still listed in the current snapshot, requires _handlers_mutex
+        conflation_slot_t conflation;
+#if defined(EVDS_ENABLE_STATS)
+        details::event_counters counters;
+#endif
+
+    private:
+        std::atomic<const published_event_t*> _snapshot;
+    };
+
+    using channels_t = std::unordered_map<event_id_t, std::shared_ptr<event_channel_t>>;
+
+    struct handler_entry_t
     {
-        using WrapperT = typename evds::details::function_traits<HandlerT>::wrapper_t;
-        static_assert(std::is_same_v<void, std::invoke_result_t<HandlerT, Args...>>, "\nevent_handler must return void!");
-        static_assert(std::is_same_v<std::function<void(std::decay_t<Args>...)>, WrapperT>, 
-            "\nevent_handler arguments mismatch in add_handler()!"
-            "\nplease match your handler arguments (input parameters) with your declaration (template specification)");
+        std::shared_ptr<event_channel_t> channel;
+        std::shared_ptr<base_handler_t> handler;
+    };
 
-        const auto event_handler_id = get_event_handler_id<Args...>(std::move(event_name));
+    struct alignas(details::cache_line_size) lane_depth_t
+    {
+        std::atomic<std::size_t> events{0};      // lane queue and spill
+        std::atomic<std::size_t> spilled{0};
+        std::atomic<std::size_t> emit_tasks{0};  // tasks of emitted events, bounded by the lane capacity
+    };
 
-        std::unique_lock handlers_lock(_handlers_mutex);        
-        _handlers[event_handler_id].emplace_back(std::make_unique<handler_t<Args...>>(++handler_id, std::move(event_handler)));
-        return handler_id;
-    }
+    // Tasks that found a bounded lane queue full. Producers never wait for room: a dispatcher thread emitting
+    // from a handler would wait for itself. Until the spill is empty new tasks follow it, so the lane stays FIFO.
+    struct lane_spill_t
+    {
+        std::mutex mutex;
+        details::circular_buffer<event_t> tasks;
+    };
 
-    auto remove_handler(unsigned long handler_id) -> bool
+    using lane_credits_t = std::array<std::size_t, event_priorities_count>;
+
+    struct overflow_counters_t
+    {
+        std::atomic<std::size_t> dropped_newest{0};
+        std::atomic<std::size_t> dropped_oldest{0};
+        std::atomic<std::size_t> rejected{0};
+        std::atomic<std::size_t> timed_out{0};
+    };
+
+    // Work posted to an executor reaches the dispatcher through its link: stop() cuts it once the running work has returned.
+    struct executor_link_t
+    {
+        explicit executor_link_t(basic_event_dispatcher* dispatcher) noexcept : dispatcher{dispatcher} {}
+
+        std::shared_mutex mutex;
+        basic_event_dispatcher* dispatcher;
+    };
+
+    struct base_awaiters_t
     {
-        std::unique_lock handlers_lock(_handlers_mutex);        
+        virtual ~base_awaiters_t() noexcept {}
+
+        // Called by stop(): coroutines still waiting are destroyed along with the task that owns them.
+        virtual void destroy_waiting() = 0;
+    };
 
-        for(auto&& event_handlers : _handlers)
+    // Coroutines waiting for the next emit of an event: each one is resumed once, on a dispatcher thread.
+    template <typename... Args>
+    struct awaiters_t final : base_awaiters_t
+    {
+        struct waiter_t
         {
-            if(std::erase_if(event_handlers.second, [handler_id](auto&& h){ return h->id == handler_id; }))
-                return true;
+            std::coroutine_handle<> coroutine;
+            std::coroutine_handle<> owner; // null when not owned by a started task: never destroyed then
+            std::optional<std::tuple<Args...>>* args;
+        };
+
+        void destroy_waiting() override
+        {
+            std::vector<waiter_t> destroyed;
+            {
+                std::scoped_lock awaiters_lock(mutex);
+                destroyed.swap(waiting);
+            }
+
+            for (auto&& waiter : destroyed)
+            {
+                if (waiter.owner)
+                    waiter.owner.destroy();
+            }
         }
 
-        return false;
-    }
+        std::mutex mutex;
+        std::vector<waiter_t> waiting;
+    };
+
+    // Queued resume of a coroutine that waited on next(). Dropped unrun (stop) it destroys the task owning the coroutine.
+    class resume_task_t
+    {
+    public:
+        resume_task_t(std::coroutine_handle<> coroutine, std::coroutine_handle<> owner) noexcept : _coroutine{coroutine}, _owner{owner} {}
+        resume_task_t(resume_task_t&& other) noexcept : _coroutine{std::exchange(other._coroutine, {})}, _owner{std::exchange(other._owner, {})} {}
+        resume_task_t(const resume_task_t&) = delete;
+        resume_task_t& operator=(const resume_task_t&) = delete;
+        resume_task_t& operator=(resume_task_t&&) = delete;
+
+        ~resume_task_t()
+        {
+            if (_owner)
+                _owner.destroy();
+        }
+
+        void operator()()
+        {
+            _owner = {};
+            std::exchange(_coroutine, {}).resume();
+        }
 
+    private:
+        std::coroutine_handle<> _coroutine;
+        std::coroutine_handle<> _owner;
+    };
+
+    // Queued task of a conflated event. Dropped unrun (drop_oldest, stop) it still releases its slot.
     template <typename... Args>
-    auto emit(std::string event_name, Args... args) -> bool
+    class flush_task_t
     {
-        const auto event_handler_id = get_event_handler_id<Args...>(std::move(event_name));
+    public:
+        explicit flush_task_t(conflation_slot_t* slot) noexcept : _slot{slot} {}
+        flush_task_t(flush_task_t&& other) noexcept : _slot{std::exchange(other._slot, nullptr)} {}
+        flush_task_t(const flush_task_t&) = delete;
+        flush_task_t& operator=(const flush_task_t&) = delete;
+        flush_task_t& operator=(flush_task_t&&) = delete;
 
-        std::unique_lock handlers_lock(_handlers_mutex);
-        if (!_handlers.contains(event_handler_id))
-            return false;
+        ~flush_task_t()
+        {
+            if (_slot)
+                _slot->take();
+        }
+
+        void operator()()
+        {
+            if (const auto payload = std::static_pointer_cast<const event_payload_t<Args...>>(std::exchange(_slot, nullptr)->take()))
+                call_handlers<Args...>(*payload, 0, payload->handlers->size());
+        }
+
+    private:
+        conflation_slot_t* _slot;
+    };
+
+    // Shared by every task queued for a single emit: arguments are stored once, whatever the number of handlers.
+    template <typename... Args>
+    struct event_payload_t
+    {
+        template <typename... CtorArgs>
+        explicit event_payload_t(std::shared_ptr<const handlers_t> handlers, CtorArgs&&... ctor_args)
+            : handlers{std::move(handlers)}, args{std::in_place, std::forward<CtorArgs>(ctor_args)...} {}
+
+        std::shared_ptr<const handlers_t> handlers;
+        details::payload_t<Args...> args;
+#if defined(EVDS_ENABLE_STATS) || defined(EVDS_ENABLE_TRACING)
+        std::chrono::steady_clock::time_point queued_at;
+#endif
+#if defined(EVDS_ENABLE_STATS)
+        details::event_counters* counters = nullptr;
+#endif
+#if defined(EVDS_ENABLE_TRACING)
+        details::trace_log* trace = nullptr;
+        event_id_t event_id = 0;
+        std::uint64_t emit_id = 0;
+#endif
+    };
 
-        std::vector<std::shared_ptr<base_handler_t>> event_handlers = _handlers.at(event_handler_id);
-        handlers_lock.unlock();
+public:
+    using events_queue_t = typename QueuePolicy::template queue_t<event_t>;
+
+    // Pre-resolved event: emit() goes straight to the event's handler list, skipping name hashing and table lookup.
+    // Must not outlive the dispatcher that created it.
+    template <typename... Args>
+    class event_handle
+    {
+    public:
+        event_handle(basic_event_dispatcher* dispatcher, std::shared_ptr<event_channel_t> channel) noexcept
+            : _dispatcher{dispatcher}, _channel{std::move(channel)} {}
 
-        for (auto&& h : event_handlers)
+        auto emit(std::type_identity_t<Args>... args) const -> bool
         {
-            const event_t event = [e = std::static_pointer_cast<handler_t<Args...>>(h), ... args = std::forward<Args>(args)]
-            {
-                return std::invoke(&handler_t<Args...>::call, e.get(), args...);
-            };
+            auto event = _dispatcher->find_event(*_channel);
+            return _dispatcher->template enqueue_events<Args...>(std::move(event), route_of(event), std::move(args)...);
+        }
 
-            std::unique_lock events_lock(_events_mutex);
-            _events_queue.emplace(event);
-            events_lock.unlock();
+        auto emit(event_priority priority, std::type_identity_t<Args>... args) const -> bool
+        {
+            auto event = _dispatcher->find_event(*_channel);
+            return _dispatcher->template enqueue_events<Args...>(std::move(event), {priority, event.strand}, std::move(args)...);
+        }
 
-            _dispatcher_cv.notify_one();
+        auto emit(strand_key strand, std::type_identity_t<Args>... args) const -> bool
+        {
+            auto event = _dispatcher->find_event(*_channel);
+            return _dispatcher->template enqueue_events<Args...>(std::move(event), {event.options.priority, strand.value}, std::move(args)...);
         }
 
-        return true;
-    }
+        auto emit_sync(std::type_identity_t<Args>... args) const -> bool
+        {
+            return _dispatcher->template dispatch_sync<Args...>(_dispatcher->find_sync_event(*_channel), std::move(args)...);
+        }
 
-    auto start(const unsigned int num_threads = 1) -> bool
-    {
+        auto try_emit(std::type_identity_t<Args>... args) const -> emit_status
         {
-            std::scoped_lock lock(_is_running_mutex);
-            if(_is_running)
-                return false;
+            auto event = _dispatcher->find_event(*_channel);
+            return _dispatcher->template push_events<Args...>(std::move(event), route_of(event), false, std::move(args)...);
         }
 
-        auto dispatcher_threads_barrier_callback = [this]() noexcept
+    private:
+        basic_event_dispatcher* _dispatcher;
+        std::shared_ptr<event_channel_t> _channel;
+    };
+
+    // Cancels a timer started by emit_after(), emit_at() or emit_every(). Must not outlive the dispatcher that created it.
+    class timer_handle
+    {
+    public:
+        timer_handle() noexcept = default;
+        timer_handle(basic_event_dispatcher* dispatcher, std::uint64_t id) noexcept : _dispatcher{dispatcher}, _id{id} {}
+
+        // False when the timer already fired (one-shot), was cancelled or was dropped by stop().
+        // Once true the timer does not fire again, even when it was due and about to fire on a dispatcher thread.
+        auto cancel() const -> bool
         {
-            std::scoped_lock lock(_is_running_mutex);
-            _is_running = true;
-        };
+            return _dispatcher && _dispatcher->cancel_timer(_id);
+        }
 
-        const auto thread_count = std::clamp(num_threads, 1u, std::thread::hardware_concurrency());
-        _dispatcher_threads.reserve(thread_count);
+    private:
+        basic_event_dispatcher* _dispatcher = nullptr;
+        std::uint64_t _id = 0;
+    };
 
-        using barrier_t = std::barrier<decltype(dispatcher_threads_barrier_callback)>;
-        auto dispatcher_threads_barrier = std::make_shared<barrier_t>(thread_count + 1, dispatcher_threads_barrier_callback);
-        const auto dispatcher_thread = [this, &dispatcher_threads_barrier]()
+    // Awaitable returned by next(). Events emitted before the coroutine suspends on it are not seen.
+    template <typename... Args>
+    class next_event
+    {
+    public:
+        explicit next_event(std::shared_ptr<awaiters_t<Args...>> awaiters) noexcept : _awaiters{std::move(awaiters)} {}
+
+        auto await_ready() const noexcept -> bool
         {
-            dispatcher_threads_barrier->arrive_and_wait();
-            run();
-        };
+            return false;
+        }
 
-        for (auto i = 0; i < thread_count; ++i)
-            _dispatcher_threads.emplace_back(dispatcher_thread);
+        // The coroutine may be resumed on another thread as soon as the lock is released: the frame is not touched after it.
+        template <typename PromiseT>
+        void await_suspend(std::coroutine_handle<PromiseT> coroutine)
+        {
+            const auto awaiters = _awaiters;
+            std::scoped_lock awaiters_lock(awaiters->mutex);
+            awaiters->waiting.push_back({coroutine, details::owning_frame(coroutine), &_args});
+        }
 
-        dispatcher_threads_barrier->arrive_and_wait();
-        return true;
-    }
+        auto await_resume() -> details::awaited_event_t<Args...>
+        {
+            if constexpr (sizeof...(Args) == 1)
+                return std::get<0>(std::move(*_args));
+            else if constexpr (sizeof...(Args) > 1)
+                return std::move(*_args);
+        }
 
-    auto stop() -> bool
+    private:
+        std::shared_ptr<awaiters_t<Args...>> _awaiters;
+        std::optional<std::tuple<Args...>> _args;
+    };
+
+    // Gathers emits and enqueues all of them at once, in a single queue operation, on submit() or destruction.
+    // Handlers are resolved once per event for the lifetime of the batch.
+    // The lane capacity is checked once per lane on submit(): an admitted lane may go over it by the batch size.
+    class batch
     {
+    public:
+        explicit batch(basic_event_dispatcher& dispatcher) noexcept : _dispatcher{dispatcher} {}
+
+        ~batch()
         {
-            std::scoped_lock lock(_is_running_mutex);
-            if(!_is_running)
-                return false;
-            
-            _is_running = false;
+            submit();
         }
 
-        _dispatcher_cv.notify_all();
-        
+        batch(const batch&) = delete;
+        batch(batch&&) noexcept = delete;
+        batch& operator=(const batch&) = delete;
+        batch& operator=(batch&&) = delete;
+
+        template <typename... Args>
+        auto emit(std::string event_name, Args... args) -> bool
         {
-            std::scoped_lock handlers_lock(_handlers_mutex);
-            _handlers.clear();
+            return add_events<Args...>(get_event_handler_id<Args...>(event_name), args...);
         }
 
+        template <fixed_string EventName, typename... Args>
+        auto emit(Args... args) -> bool
         {
-            std::scoped_lock events_lock(_events_mutex);
-            _events_queue = {};
+            constexpr auto event_handler_id = get_event_handler_id<Args...>(EventName.view());
+            return add_events<Args...>(event_handler_id, args...);
         }
 
-        for (auto&& thread : _dispatcher_threads)
+        template <typename... Args>
+        auto emit(const event_key<Args...>& key, std::type_identity_t<Args>... args) -> bool
         {
-            if (thread.joinable())
-                thread.join();
+            return add_events<std::decay_t<Args>...>(key.id, args...);
         }
-            
-        return true;
+
+        // Each lane is admitted as a whole, ordered events included: on a full lane the overflow policy applies to all of its events.
+        void submit()
+        {
+            std::array<bool, event_priorities_count> is_admitted{};
+            for (std::size_t lane = 0; lane < event_priorities_count; ++lane)
+            {
+                const bool has_ordered = std::ranges::any_of(_ordered_events, [lane](auto&& ordered){ return lane_index(ordered.first.priority) == lane; });
+                if (_events[lane].empty() && !has_ordered)
+                    continue;
+
+                is_admitted[lane] = _dispatcher.admit(lane, true) == emit_status::queued;
+                if (is_admitted[lane])
+                    _dispatcher.enqueue_bulk(_events[lane], static_cast<event_priority>(lane));
+                _events[lane].clear();
+            }
+
+            for (auto&& [route, event] : _ordered_events)
+            {
+                if (is_admitted[lane_index(route.priority)])
+                    _dispatcher.push_routed(std::move(event), route);
+            }
+            _ordered_events.clear();
+
+            for (auto&& conflate : _conflated_events)
+                conflate();
+            _conflated_events.clear();
+        }
+
+    private:
+        template <typename... Args>
+        auto add_events(event_id_t event_handler_id, const Args&... args) -> bool
+        {
+            auto event_it = _snapshots.find(event_handler_id);
+            if (event_it == _snapshots.end())
+                event_it = _snapshots.emplace(event_handler_id, _dispatcher.template find_event<Args...>(event_handler_id)).first;
+
+            // A conflated emit replaces the pending payload of its event: it is only made on submit.
+            const auto& event = event_it->second;
+            if (event.conflation)
+            {
+                if (!event.handlers || event.handlers->empty())
+                    return false;
+
+                _conflated_events.emplace_back([&dispatcher = _dispatcher, event = event_snapshot_t{event}, args...]() mutable
+                {
+                    dispatcher.template push_events<Args...>(std::move(event), route_of(event), true, args...);
+                }, _dispatcher._task_pool);
+                return true;
+            }
+
+            bool added = false;
+            if (event.strand)
+            {
+                added = _dispatcher.template make_events<Args...>(event_snapshot_t{event}, event.options.priority, [this, &event](event_t&& e)
+                {
+                    _ordered_events.emplace_back(route_of(event), std::move(e)); 
+                }, args...);
+            }
+            else
+            {
+                auto& events = _events[lane_index(event.options.priority)];
+                added = _dispatcher.template make_events<Args...>(event_snapshot_t{event}, event.options.priority, [&events](event_t&& e){ events.emplace_back(std::move(e)); }, args...);
+            }
+
+#if defined(EVDS_ENABLE_STATS)
+            _dispatcher.counters_of(event).count_emit(added ? emit_status::queued : emit_status::no_handlers);
+#endif
+            return added;
+        }
+
+        basic_event_dispatcher& _dispatcher;
+        std::unordered_map<event_id_t, event_snapshot_t> _snapshots;
+        std::array<std::vector<event_t>, event_priorities_count> _events;
+        std::vector<std::pair<route_t, event_t>> _ordered_events;
+        std::vector<event_t> _conflated_events;
+    };
+
+    explicit basic_event_dispatcher(const dispatcher_options& options = {}) noexcept : _is_running{false}, _options{options}
+    {
     }
 
-protected:
-    void run()
+    // Coroutines waiting on a dispatcher that is not running are destroyed as well.
+    ~basic_event_dispatcher() noexcept
     {
-        while(_is_running)
-        {
-            std::unique_lock events_lock(_events_mutex);
-            
-            _dispatcher_cv.wait(events_lock, [this]{ return !_events_queue.empty() || !_is_running; });
-            if (!_is_running)
-                return;
+        stop();
+        destroy_awaiters();
+        delete _channels.load(std::memory_order_relaxed);
+    }
 
-            const event_t event = std::move(_events_queue.front());
-            _events_queue.pop();
-            events_lock.unlock();
+    basic_event_dispatcher(const basic_event_dispatcher&) = delete;
+    basic_event_dispatcher(basic_event_dispatcher&&) noexcept = delete;
+    basic_event_dispatcher& operator=(const basic_event_dispatcher&) = delete;
+    basic_event_dispatcher& operator=(basic_event_dispatcher&&) = delete;
 
-            event();
+    template <typename... Args>
+    static constexpr auto get_event_handler_id(std::string_view event_name) -> event_id_t
+    {
+        return make_event_id<std::decay_t<Args>...>(event_name);
+    }
+
+    template <typename... Args, typename HandlerT>
+    auto add_handler(std::string event_name, HandlerT&& event_handler, const handler_options& options = {}) -> unsigned long
+    {
+        return add_event_handler<Args...>(get_event_handler_id<Args...>(event_name), event_name, std::forward<HandlerT>(event_handler), options);
+    }
+
+    template <fixed_string EventName, typename... Args, typename HandlerT>
+    auto add_handler(HandlerT&& event_handler, const handler_options& options = {}) -> unsigned long
+    {
+        constexpr auto event_handler_id = get_event_handler_id<Args...>(EventName.view());
+        return add_event_handler<Args...>(event_handler_id, EventName.view(), std::forward<HandlerT>(event_handler), options);
+    }
+
+    template <typename... Args, typename HandlerT>
+    auto add_handler(const event_key<Args...>& key, HandlerT&& event_handler, const handler_options& options = {}) -> unsigned long
+    {
+        return add_event_handler<Args...>(key.id, key.name, std::forward<HandlerT>(event_handler), options);
+    }
+
+    // Removed handlers are only flagged: they stay in the event handlers list as tombstones, skipped by every call,
+    // until they make up half of the list. The list is then republished without them, so removal is amortized O(1).
+    // An event whose handlers are all removed is compacted right away: emits report it has no handlers.
+    auto remove_handler(unsigned long handler_id) -> bool
+    {
+        std::unique_lock handlers_lock(_handlers_mutex);
+        const auto handler_it = _handlers_index.find(handler_id);
+        if (handler_it == _handlers_index.end())
+            return false;
+
+        const auto [channel, handler] = std::move(handler_it->second);
+        _handlers_index.erase(handler_it);
+        handler->removed.store(true, std::memory_order_release);
+
+        const auto& current = channel->current().event;
+        if (2 * ++channel->tombstones >= current.handlers->size())
+        {
+            publish(*channel, live_handlers(*current.handlers), current.options);
+            channel->tombstones = 0;
         }
+
+        return true;
+    }
+
+    template <typename... Args>
+    void configure_event(std::string_view event_name, const event_options& options)
+    {
+        configure_channel<Args...>(get_event_handler_id<Args...>(event_name), event_name, options);
+    }
+
+    template <typename... Args>
+    void configure_event(const event_key<Args...>& key, const event_options& options)
+    {
+        configure_channel<Args...>(key.id, key.name, options);
+    }
+
+    // Payloads are Args values, or std::tuple<Args...> for events with more than one argument.
+    // Args defaults to the range value type. False when any payload was not queued.
+    template <typename... Args, std::ranges::input_range RangeT>
+    auto emit_batch(std::string event_name, RangeT&& payloads) -> bool
+    {
+        if constexpr (sizeof...(Args) == 0)
+        {
+            return emit_batch<std::ranges::range_value_t<RangeT>>(std::move(event_name), std::forward<RangeT>(payloads));
+        }
+        else
+        {
+            const auto event = find_event<Args...>(get_event_handler_id<Args...>(event_name));
+            if (event.conflation)
+            {
+                // Only the newest payload of a conflated event matters: there is nothing to push in bulk.
+                bool is_queued = false;
+                for (auto&& payload : payloads)
+                {
+                    const auto push = [this, &event](const auto&... args)
+                    {
+                        return push_events<std::decay_t<Args>...>(event_snapshot_t{event}, route_of(event), true, args...) == emit_status::queued;
+                    };
+
+                    if constexpr (sizeof...(Args) == 1)
+                        is_queued = push(payload);
+                    else
+                        is_queued = std::apply(push, payload);
+                }
+                return is_queued;
+            }
+
+            if (!event.handlers || event.handlers->empty())
+            {
+#if defined(EVDS_ENABLE_STATS)
+                counters_of(event).count_emit(emit_status::no_handlers);
+#endif
+                return false;
+            }
+
+            // Every payload is admitted as a single emit would be. The events gathered so far are pushed first
+            // when they would fill the lane, so that admit() sees them.
+            // Ordered events go through their strand one by one, the others are pushed in bulk.
+            const auto lane = lane_index(event.options.priority);
+            const auto capacity = _options.lane_capacity;
+            std::vector<event_t> events;
+            if constexpr (std::ranges::sized_range<RangeT>)
+                events.reserve(event.strand ? 0 : std::ranges::size(payloads));
+
+            bool is_queued = true;
+            for (auto&& payload : payloads)
+            {
+                if (capacity != 0 && !events.empty() && _lane_depths[lane].emit_tasks.load(std::memory_order_relaxed) + events.size() >= capacity)
+                {
+                    enqueue_bulk(events, event.options.priority);
+                    events.clear();
+                }
+
+                const auto status = admit(lane, true);
+#if defined(EVDS_ENABLE_STATS)
+                counters_of(event).count_emit(status);
+#endif
+                if (status != emit_status::queued)
+                {
+                    is_queued = false;
+                    continue;
+                }
+
+                const auto add_events = [this, &event, &events](const auto&... args)
+                {
+                    make_events<std::decay_t<Args>...>(event_snapshot_t{event}, event.options.priority, [this, &event, &events](event_t&& e)
+                    { 
+                        if (!event.strand)
+                            events.emplace_back(std::move(e));
+                        else
+                            push_routed(std::move(e), route_of(event));
+                    }, args...);
+                };
+
+                if constexpr (sizeof...(Args) == 1)
+                    add_events(payload);
+                else
+                    std::apply(add_events, payload);
+            }
+
+            enqueue_bulk(events, event.options.priority);
+            return is_queued;
+        }
+    }
+
+    template <typename... Args>
+    auto register_event(std::string_view event_name) -> event_handle<std::decay_t<Args>...>
+    {
+        std::unique_lock handlers_lock(_handlers_mutex);
+        return {this, get_channel<Args...>(get_event_handler_id<Args...>(event_name), event_name)};
+    }
+
+    template <typename... Args>
+    auto register_event(const event_key<Args...>& key) -> event_handle<std::decay_t<Args>...>
+    {
+        std::unique_lock handlers_lock(_handlers_mutex);
+        return {this, get_channel<Args...>(key.id, key.name)};
+    }
+
+    // co_await next<Args...>(event_name) suspends the calling coroutine until the event is emitted,
+    // then resumes it on a dispatcher thread with the event arguments. Suspended coroutines hold no thread.
+    // Coroutines still waiting when the dispatcher stops are never resumed: those run by a started task are destroyed.
+    template <typename... Args>
+    auto next(std::string_view event_name) -> next_event<std::decay_t<Args>...>
+    {
+        return next_event<std::decay_t<Args>...>{get_awaiters<std::decay_t<Args>...>(get_event_handler_id<Args...>(event_name), event_name)};
+    }
+
+    template <typename... Args>
+    auto next(const event_key<Args...>& key) -> next_event<std::decay_t<Args>...>
+    {
+        return next_event<std::decay_t<Args>...>{get_awaiters<std::decay_t<Args>...>(key.id, key.name)};
+    }
+
+    // Compatibility path: the event key is hashed from the name at runtime on every call.
+    template <typename... Args>
+    auto emit(std::string event_name, Args... args) -> bool
+    {
+        return emit_event<Args...>(get_event_handler_id<Args...>(event_name), std::move(args)...);
+    }
+
+    template <fixed_string EventName, typename... Args>
+    auto emit(Args... args) -> bool
+    {
+        constexpr auto event_handler_id = get_event_handler_id<Args...>(EventName.view());
+        return emit_event<Args...>(event_handler_id, std::move(args)...);
+    }
+
+    template <typename... Args>
+    auto emit(const event_key<Args...>& key, std::type_identity_t<Args>... args) -> bool
+    {
+        return emit_event<std::decay_t<Args>...>(key.id, std::move(args)...);
+    }
+
+    // Never waits: reports whether the event was queued, or what the overflow policy did with it.
+    template <typename... Args>
+    auto try_emit(std::string event_name, Args... args) -> emit_status
+    {
+        auto event = find_event<Args...>(get_event_handler_id<Args...>(event_name));
+        return push_events<Args...>(std::move(event), route_of(event), false, std::move(args)...);
+    }
+
+    template <typename... Args>
+    auto try_emit(const event_key<Args...>& key, std::type_identity_t<Args>... args) -> emit_status
+    {
+        auto event = find_event<Args...>(key.id);
+        return push_events<std::decay_t<Args>...>(std::move(event), route_of(event), false, std::move(args)...);
+    }
+
+    // Overrides the event default priority for this emit only.
+    template <typename... Args>
+    auto emit(event_priority priority, std::string event_name, Args... args) -> bool
+    {
+        auto event = find_event<Args...>(get_event_handler_id<Args...>(event_name));
+        return enqueue_events<Args...>(std::move(event), {priority, event.strand}, std::move(args)...);
+    }
+
+    template <typename... Args>
+    auto emit(event_priority priority, const event_key<Args...>& key, std::type_identity_t<Args>... args) -> bool
+    {
+        auto event = find_event<Args...>(key.id);
+        return enqueue_events<std::decay_t<Args>...>(std::move(event), {priority, event.strand}, std::move(args)...);
+    }
+
+    // Emits with the same strand key run serially in emit order, different keys may run in parallel.
+    template <typename... Args>
+    auto emit(strand_key strand, std::string event_name, Args... args) -> bool
+    {
+        auto event = find_event<Args...>(get_event_handler_id<Args...>(event_name));
+        return enqueue_events<Args...>(std::move(event), {event.options.priority, strand.value}, std::move(args)...);
+    }
+
+    template <typename... Args>
+    auto emit(strand_key strand, const event_key<Args...>& key, std::type_identity_t<Args>... args) -> bool
+    {
+        auto event = find_event<Args...>(key.id);
+        return enqueue_events<std::decay_t<Args>...>(std::move(event), {event.options.priority, strand.value}, std::move(args)...);
+    }
+
+    // Inline-safe handlers run right away on the calling thread, the others are queued as emit() does.
+    // Inline handlers run even if the dispatcher is not started.
+    template <typename... Args>
+    auto emit_sync(std::string event_name, Args... args) -> bool
+    {
+        return dispatch_sync<Args...>(find_sync_event<Args...>(get_event_handler_id<Args...>(event_name)), std::move(args)...);
+    }
+
+    template <fixed_string EventName, typename... Args>
+    auto emit_sync(Args... args) -> bool
+    {
+        constexpr auto event_handler_id = get_event_handler_id<Args...>(EventName.view());
+        return dispatch_sync<Args...>(find_sync_event<Args...>(event_handler_id), std::move(args)...);
+    }
+
+    template <typename... Args>
+    auto emit_sync(const event_key<Args...>& key, std::type_identity_t<Args>... args) -> bool
+    {
+        return dispatch_sync<std::decay_t<Args>...>(find_sync_event<Args...>(key.id), std::move(args)...);
+    }
+
+    // Builds the T payload directly inside the block shared by every handler of the event.
+    template <typename T, typename... CtorArgs>
+    auto emplace_emit(std::string event_name, CtorArgs&&... ctor_args) -> bool
+    {
+        return emplace_event<std::decay_t<T>>(get_event_handler_id<T>(event_name), std::forward<CtorArgs>(ctor_args)...);
+    }
+
+    template <typename T, typename... CtorArgs>
+    auto emplace_emit(const event_key<T>& key, CtorArgs&&... ctor_args) -> bool
+    {
+        return emplace_event<std::decay_t<T>>(key.id, std::forward<CtorArgs>(ctor_args)...);
+    }
+
+    // Emits the event from a dispatcher thread once delay has elapsed. Timers tick every millisecond: deadlines are rounded up,
+    // and they only fire while the dispatcher runs. Timer emits never block: a full lane is handled as by try_emit().
+    // Pending timers are dropped by stop().
+    template <typename... Args>
+    auto emit_after(std::chrono::steady_clock::duration delay, std::string event_name, Args... args) -> timer_handle
+    {
+        return emit_at<Args...>(std::chrono::steady_clock::now() + delay, std::move(event_name), std::move(args)...);
+    }
+
+    template <typename... Args>
+    auto emit_after(std::chrono::steady_clock::duration delay, const event_key<Args...>& key, std::type_identity_t<Args>... args) -> timer_handle
+    {
+        return add_timer<std::decay_t<Args>...>(std::chrono::steady_clock::now() + delay, {}, key.id, std::move(args)...);
+    }
+
+    template <typename... Args>
+    auto emit_at(std::chrono::steady_clock::time_point deadline, std::string event_name, Args... args) -> timer_handle
+    {
+        return add_timer<Args...>(deadline, {}, get_event_handler_id<Args...>(event_name), std::move(args)...);
+    }
+
+    template <typename... Args>
+    auto emit_at(std::chrono::steady_clock::time_point deadline, const event_key<Args...>& key, std::type_identity_t<Args>... args) -> timer_handle
+    {
+        return add_timer<std::decay_t<Args>...>(deadline, {}, key.id, std::move(args)...);
+    }
+
+    // Emits the event every period, the first time one period from now, until cancelled.
+    // A late timer skips the missed periods instead of catching up. Periods shorter than a tick, zero or negative ones
+    // included, are clamped to one tick.
+    template <typename... Args>
+    auto emit_every(std::chrono::steady_clock::duration period, std::string event_name, Args... args) -> timer_handle
+    {
+        period = std::max<std::chrono::steady_clock::duration>(period, timer_resolution);
+        return add_timer<Args...>(std::chrono::steady_clock::now() + period, period, get_event_handler_id<Args...>(event_name), std::move(args)...);
+    }
+
+    template <typename... Args>
+    auto emit_every(std::chrono::steady_clock::duration period, const event_key<Args...>& key, std::type_identity_t<Args>... args) -> timer_handle
+    {
+        period = std::max<std::chrono::steady_clock::duration>(period, timer_resolution);
+        return add_timer<std::decay_t<Args>...>(std::chrono::steady_clock::now() + period, period, key.id, std::move(args)...);
+    }
+
+    auto start(const unsigned int num_threads = 1) -> bool
+    {
+        start_options options;
+        options.threads = num_threads;
+        return start(options);
+    }
+
+    // Threads are pinned and named before start() returns. When pinning fails the thread runs wherever the OS puts it:
+    // pinned_threads() tells how many were actually pinned.
+    auto start(const start_options& options) -> bool
+    {
+        {
+            std::scoped_lock lock(_is_running_mutex);
+            if(_is_running)
+                return false;
+        }
+
+        auto dispatcher_threads_barrier_callback = [this]() noexcept
+        {
+            std::scoped_lock lock(_is_running_mutex);
+            _is_running = true;
+        };
+
+        std::scoped_lock pool_lock(_pool_mutex);
+
+        // hardware_concurrency() is 0 when it cannot be computed.
+        const auto thread_count = std::clamp(options.threads, 1u, std::max(std::thread::hardware_concurrency(), 1u));
+        const auto max_threads = std::max(options.max_threads, thread_count);
+        _start_options = options;
+        _pinned_threads = 0;
+        // Spinning on a single CPU only delays the producers we are waiting for.
+        _wait_strategy = options.wait == wait_strategy::spin_then_park && std::thread::hardware_concurrency() <= 1 ? wait_strategy::blocking : options.wait;
+        _spin_iterations = std::max(options.spin_iterations, 1u);
+        _min_threads = thread_count;
+        _max_threads = max_threads;
+        _running_threads = thread_count;
+        _grow_queue_depth = std::max<std::size_t>(options.grow_queue_depth, 1);
+        _last_pool_change = std::chrono::steady_clock::now();
+        _overloaded_since = not_overloaded;
+
+        // One slot per possible thread: elastic threads reuse the slots (and worker queues) of retired ones.
+        _dispatcher_threads.resize(max_threads);
+        _active_workers = std::make_unique<std::atomic_bool[]>(max_threads);
+
+        using barrier_t = std::barrier<decltype(dispatcher_threads_barrier_callback)>;
+        auto dispatcher_threads_barrier = std::make_shared<barrier_t>(thread_count + 1, dispatcher_threads_barrier_callback);
+        const auto dispatcher_thread = [this, dispatcher_threads_barrier](std::size_t worker)
+        {
+            prepare_worker(worker);
+            dispatcher_threads_barrier->arrive_and_wait();
+            run();
+        };
+
+        for (auto i = 0u; i < thread_count; ++i)
+        {
+            _active_workers[i] = true;
+            _dispatcher_threads[i] = std::thread(dispatcher_thread, i);
+        }
+
+        dispatcher_threads_barrier->arrive_and_wait();
+        return true;
+    }
+
+    // Runs the dispatcher on an executor instead of its own threads, e.g. a thread_pool shared by several dispatchers.
+    // While events are queued, up to concurrency work items drain them: each one posts itself again after 64 events,
+    // so that dispatchers sharing the executor take turns. Timers need a timed_executor to fire when no event is queued.
+    // Wait strategies, pinning and the elastic pool only apply to the dispatcher own threads. The executor must outlive stop().
+    template <executor ExecutorT>
+    auto start(ExecutorT& executor, unsigned int concurrency = 1) -> bool
+    {
+        {
+            std::scoped_lock lock(_is_running_mutex);
+            if(_is_running)
+                return false;
+        }
+
+        std::scoped_lock pool_lock(_pool_mutex);
+        _executor = details::any_executor{executor};
+        _executor_concurrency = std::max(concurrency, 1u);
+        _executor_link = std::make_shared<executor_link_t>(this);
+        _active_drains = 0;
+        _armed_timer_tick = details::timer_wheel::never;
+
+        {
+            std::scoped_lock lock(_is_running_mutex);
+            _is_running = true;
+        }
+        _uses_executor.store(true, std::memory_order_release);
+
+        // Events emitted before start().
+        post_drains(queued_events());
+        arm_timer_wake();
+        return true;
+    }
+
+    // With drain_policy::drain, queued events are handled first, for up to timeout: the remaining ones are discarded.
+    auto stop(drain_policy policy = drain_policy::discard, std::chrono::milliseconds timeout = std::chrono::seconds(5)) -> bool
+    {
+        if (policy == drain_policy::drain && _is_running)
+            wait_idle(timeout);
+
+        {
+            std::scoped_lock lock(_is_running_mutex);
+            if(!_is_running)
+                return false;
+            
+            _is_running = false;
+        }
+
+        {
+            std::scoped_lock dispatcher_lock(_dispatcher_mutex);
+        }
+        _dispatcher_cv.notify_all();
+        
+        {
+            std::scoped_lock handlers_lock(_handlers_mutex);
+            if (const auto* channels = _channels.load(std::memory_order_relaxed))
+            {
+                std::vector<std::unique_ptr<const published_event_t>> retired;
+                for (auto&& [event_handler_id, channel] : *channels)
+                {
+                    auto snapshot = channel->current();
+                    snapshot.event.handlers = snapshot.queued_event.handlers = snapshot.inline_handlers = nullptr;
+                    retired.emplace_back(channel->exchange(std::move(snapshot)));
+                    channel->tombstones = 0;
+
+                    std::scoped_lock slot_lock(channel->conflation.mutex);
+                    channel->conflation.timer_id = 0;
+                    ++channel->conflation.window_id;
+                }
+                _rcu.synchronize();
+            }
+            _handlers_index.clear();
+        }
+
+        {
+            std::scoped_lock timers_lock(_timers_mutex);
+            _timers.clear();
+            _next_timer_tick = details::timer_wheel::never;
+        }
+
+        {
+            std::scoped_lock pool_lock(_pool_mutex);
+            if (_uses_executor.exchange(false))
+            {
+                std::unique_lock link_lock(_executor_link->mutex);
+                _executor_link->dispatcher = nullptr;
+            }
+
+            for (auto&& thread : _dispatcher_threads)
+            {
+                if (thread.joinable())
+                    thread.join();
+            }
+            _dispatcher_threads.clear();
+            if (_retired_thread.joinable())
+                _retired_thread.join();
+            _active_workers.reset();
+            _running_threads = 0;
+            _max_threads = 0;
+        }
+
+        for (std::size_t lane = 0; lane < event_priorities_count; ++lane)
+        {
+            event_t event;
+            while (try_pop_lane(lane, event))
+            {
+                event.reset();
+                task_done();
+            }
+        }
+
+        for (auto&& stripe : _strand_stripes)
+        {
+            std::scoped_lock stripe_lock(stripe.mutex);
+            for (auto&& [key, strand] : stripe.strands)
+            {
+                for (auto& tasks = strand.tasks; !tasks.empty(); tasks.pop_front())
+                {
+                    if (is_emit_task(tasks.front()))
+                        release_emit_task(emit_task_lane(tasks.front()));
+                    task_done();
+                }
+            }
+            stripe.strands.clear();
+        }
+
+        // Last, once no dispatcher thread can resume a waiter that would then wait again.
+        destroy_awaiters();
+        return true;
+    }
+
+    // Blocks until every queued event has been handled and every running handler has returned, or until timeout.
+    // Events emitted meanwhile are waited for as well. Queued events are only handled once the dispatcher is started.
+    auto wait_idle(std::chrono::milliseconds timeout) -> bool
+    {
+        std::unique_lock idle_lock(_idle_mutex);
+        _idle_waiters.fetch_add(1);
+        const bool is_idle = _idle_cv.wait_for(idle_lock, timeout, [this]{ return _pending_tasks.load() == 0; });
+        _idle_waiters.fetch_sub(1);
+        return is_idle;
+    }
+
+    auto events_queue(event_priority priority = event_priority::normal) const -> const events_queue_t&
+    {
+        return _events_queues[lane_index(priority)];
+    }
+
+    auto pinned_threads() const -> unsigned int
+    {
+        return _pinned_threads.load();
+    }
+
+    auto running_threads() const -> unsigned int
+    {
+        return _running_threads.load();
+    }
+
+    // Tasks of emitted events waiting in the priority lane, not yet picked up by a dispatcher thread.
+    auto queue_depth(event_priority priority) const -> std::size_t
+    {
+        return _lane_depths[lane_index(priority)].emit_tasks.load(std::memory_order_relaxed);
+    }
+
+    auto overflow_stats() const -> evds::overflow_stats
+    {
+        return {
+            _overflow_counters.dropped_newest.load(std::memory_order_relaxed),
+            _overflow_counters.dropped_oldest.load(std::memory_order_relaxed),
+            _overflow_counters.rejected.load(std::memory_order_relaxed),
+            _overflow_counters.timed_out.load(std::memory_order_relaxed)};
+    }
+
+    // Emits of conflated events whose payload was replaced by a newer one before the handlers ran.
+    auto coalesced_emits() const -> std::size_t
+    {
+        return _coalesced_emits.load(std::memory_order_relaxed);
+    }
+
+#if defined(EVDS_ENABLE_STATS)
+    // Sums up the stripes of every event counter: meant for monitoring, not for hot paths.
+    auto stats() -> dispatcher_stats
+    {
+        dispatcher_stats stats;
+        stats.total = _untracked_counters.load();
+        for (std::size_t lane = 0; lane < event_priorities_count; ++lane)
+            stats.queue_depth[lane] = _lane_depths[lane].emit_tasks.load(std::memory_order_relaxed);
+
+        std::scoped_lock handlers_lock(_handlers_mutex);
+        if (const auto* channels = _channels.load(std::memory_order_relaxed))
+        {
+            for (auto&& [event_handler_id, channel] : *channels)
+            {
+                const auto event_stats = channel->counters.load();
+                stats.total += event_stats;
+                stats.events.emplace(event_handler_id, event_stats);
+            }
+        }
+        return stats;
+    }
+#endif
+
+#if defined(EVDS_ENABLE_TRACING)
+    // Writes the records still held by the per-thread trace buffers in Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+    void dump_trace(std::ostream& out)
+    {
+        std::unordered_map<event_id_t, std::string> event_names;
+        {
+            std::scoped_lock handlers_lock(_handlers_mutex);
+            if (const auto* channels = _channels.load(std::memory_order_relaxed))
+            {
+                for (auto&& [event_handler_id, channel] : *channels)
+                    event_names.emplace(event_handler_id, channel->name);
+            }
+        }
+
+        _trace.write(out, [&event_names](event_id_t event_handler_id) -> std::string_view
+        {
+            const auto name_it = event_names.find(event_handler_id);
+            return name_it != event_names.end() ? std::string_view{name_it->second} : std::string_view{"unknown"};
+        });
+    }
+
+    auto dump_trace(const std::string& path) -> bool
+    {
+        std::ofstream out(path);
+        dump_trace(out);
+        return static_cast<bool>(out);
+    }
+#endif
+
+protected:
+    void run()
+    {
+        lane_credits_t credits = _options.lane_weights;
+        unsigned int spin_limit = _spin_iterations;
+        while(_is_running)
+        {
+            poll_timers();
+
+            event_t event;
+            if (!try_pop(event, credits) && !wait_event(event, credits, spin_limit))
+                return;
+
+            // Woken up by a due timer.
+            if (!event)
+                continue;
+
+            event();
+            task_done();
+        }
+    }
+
+    // Returns false when the dispatcher is stopped while waiting, and true with no event when a timer is due.
+    // Parked threads sleep until the next timer deadline at most.
+    // Producers only notify when some thread is parked: spinning and polling threads cost them nothing.
+    // spin_then_park doubles the thread spin budget when spinning found an event and halves it when it had to park.
+    auto wait_event(event_t& event, lane_credits_t& credits, unsigned int& spin_limit) -> bool
+    {
+        static constexpr unsigned int min_spin_limit = 16;
+        if (_wait_strategy == wait_strategy::busy_poll)
+        {
+            for (unsigned int spin = 1; _is_running; ++spin)
+            {
+                if (try_pop(event, credits))
+                    return true;
+
+                if (spin % _spin_iterations != 0)
+                    details::cpu_relax();
+                else if (timers_due())
+                    return true;
+                else
+                    std::this_thread::yield();
+            }
+            return false;
+        }
+
+        if (_wait_strategy == wait_strategy::spin_then_park)
+        {
+            for (unsigned int spin = 0; spin < spin_limit && _is_running; ++spin)
+            {
+                if (try_pop(event, credits))
+                {
+                    spin_limit = std::min(spin_limit * 2, _spin_iterations);
+                    return true;
+                }
+                details::cpu_relax();
+            }
+            spin_limit = std::max(spin_limit / 2, std::min(min_spin_limit, _spin_iterations));
+        }
+
+        std::unique_lock dispatcher_lock(_dispatcher_mutex);
+        _parked_threads.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto has_event = [this, &event, &credits]{ return try_pop(event, credits) || !_is_running || timers_due(); };
+        const bool is_elastic = _max_threads.load(std::memory_order_relaxed) != _min_threads;
+        auto idle_since = std::chrono::steady_clock::now();
+        while (!has_event())
+        {
+            const auto retire_at = is_elastic ? idle_since + _start_options.idle_timeout : std::chrono::steady_clock::time_point::max();
+            const auto wake_at = std::min(next_timer_at(), retire_at);
+            if (wake_at == std::chrono::steady_clock::time_point::max())
+            {
+                _dispatcher_cv.wait(dispatcher_lock);
+                continue;
+            }
+
+            if (_dispatcher_cv.wait_until(dispatcher_lock, wake_at) == std::cv_status::timeout && std::chrono::steady_clock::now() >= retire_at)
+            {
+                // Retiring joins the previously retired thread: producers and parking threads must not wait for it.
+                dispatcher_lock.unlock();
+                const bool is_retired = try_retire();
+                dispatcher_lock.lock();
+                if (is_retired)
+                {
+                    _parked_threads.fetch_sub(1);
+                    return false;
+                }
+                idle_since = std::chrono::steady_clock::now();
+            }
+        }
+        _parked_threads.fetch_sub(1);
+        return _is_running;
+    }
+
+    // Runs first on every dispatcher thread: queues bind (and first touch) their per-worker storage
+    // once the thread runs where it will stay.
+    void prepare_worker(std::size_t worker)
+    {
+        const auto& cpu_sets = _start_options.cpu_sets;
+        _this_thread_pinned = !cpu_sets.empty() && details::pin_this_thread(cpu_sets[worker % cpu_sets.size()]);
+        if (_this_thread_pinned)
+            _pinned_threads.fetch_add(1);
+        if (!_start_options.thread_name.empty())
+            details::name_this_thread(_start_options.thread_name + "-" + std::to_string(worker));
+
+#if defined(EVDS_ENABLE_TRACING)
+        _trace.name_this_thread((_start_options.thread_name.empty() ? std::string{"evds"} : _start_options.thread_name) + "-" + std::to_string(worker));
+#endif
+        _this_thread_dispatcher = this;
+        _this_thread_worker = worker;
+        for (auto&& events_queue : _events_queues)
+            events_queue.bind_worker(worker);
+    }
+
+    // Called on the producer side: starts a thread once every running thread has been busy, with more than
+    // grow_queue_depth queued events each, for a whole grow_interval. Bursts shorter than that add no thread.
+    void maybe_grow()
+    {
+        const auto running_threads = _running_threads.load(std::memory_order_relaxed);
+        if (running_threads >= _max_threads.load(std::memory_order_relaxed))
+            return;
+
+        if (_parked_threads.load(std::memory_order_relaxed) != 0 || queued_events() <= _grow_queue_depth.load(std::memory_order_relaxed) * running_threads)
+        {
+            if (_overloaded_since.load(std::memory_order_relaxed) != not_overloaded)
+                _overloaded_since.store(not_overloaded, std::memory_order_relaxed);
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        auto overloaded_since = _overloaded_since.load(std::memory_order_relaxed);
+        if (overloaded_since == not_overloaded && _overloaded_since.compare_exchange_strong(overloaded_since, now, std::memory_order_relaxed))
+            overloaded_since = now;
+
+        if (now - overloaded_since >= _start_options.grow_interval)
+            grow();
+    }
+
+    void grow()
+    {
+        std::unique_lock pool_lock(_pool_mutex, std::try_to_lock);
+        if (!pool_lock.owns_lock() || !_is_running)
+            return;
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - _last_pool_change < _start_options.grow_interval)
+            return;
+
+        // Retired threads have left their slot (see try_retire()): there is nothing to join here.
+        for (std::size_t worker = 0; worker < _dispatcher_threads.size(); ++worker)
+        {
+            if (_active_workers[worker] || _dispatcher_threads[worker].joinable())
+                continue;
+
+            _active_workers[worker] = true;
+            _running_threads.fetch_add(1);
+            _last_pool_change = now;
+            _overloaded_since.store(now, std::memory_order_relaxed); // the next thread needs a whole window again
+            _dispatcher_threads[worker] = std::thread([this, worker]
+            {
+                prepare_worker(worker);
+                run();
+            });
+            return;
+        }
+    }
+
+    // One work item posted to the executor. Once the lanes are empty its drain slot is released: either the next
+    // producer sees the free slot and posts a new drain, or the fence below makes us see its event.
+    void drain()
+    {
+        const auto* previous_dispatcher = std::exchange(_this_thread_dispatcher, this);
+        lane_credits_t credits = _options.lane_weights;
+        bool is_drained = false;
+        for (std::size_t i = 0; i < executor_drain_budget && _is_running && !is_drained; ++i)
+        {
+            poll_timers();
+
+            event_t event;
+            is_drained = !try_pop(event, credits);
+            if (!is_drained)
+            {
+                event();
+                task_done();
+            }
+        }
+        _this_thread_dispatcher = previous_dispatcher;
+
+        if (!is_drained && _is_running)
+        {
+            _executor.post(linked_work<&basic_event_dispatcher::drain>());
+            return;
+        }
+
+        _active_drains.fetch_sub(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_is_running && queued_events() != 0)
+            post_drains(1);
+    }
+
+    void post_drains(std::size_t events_count)
+    {
+        auto active_drains = _active_drains.load();
+        for (std::size_t posted = 0; posted < events_count && active_drains < _executor_concurrency;)
+        {
+            if (_active_drains.compare_exchange_weak(active_drains, active_drains + 1))
+            {
+                _executor.post(linked_work<&basic_event_dispatcher::drain>());
+                ++active_drains;
+                ++posted;
+            }
+        }
+    }
+
+    // Timed executors wake the dispatcher up for its next timer deadline, unless an earlier wake-up is already posted.
+    void arm_timer_wake()
+    {
+        if (!_uses_executor.load(std::memory_order_acquire) || !_executor.is_timed())
+            return;
+
+        const auto next_tick = _next_timer_tick.load(std::memory_order_relaxed);
+        auto armed_tick = _armed_timer_tick.load(std::memory_order_relaxed);
+        while (next_tick < armed_tick)
+        {
+            if (_armed_timer_tick.compare_exchange_weak(armed_tick, next_tick))
+            {
+                _executor.post_at(timer_deadline(next_tick), linked_work<&basic_event_dispatcher::on_timer_wake>());
+                return;
+            }
+        }
+    }
+
+    void on_timer_wake()
+    {
+        _armed_timer_tick = details::timer_wheel::never;
+        poll_timers();
+        arm_timer_wake();
+    }
+
+    template <void (basic_event_dispatcher::*Work)()>
+    auto linked_work() const -> std::function<void()>
+    {
+        return [link = _executor_link]
+        {
+            std::shared_lock link_lock(link->mutex);
+            if (link->dispatcher)
+                (link->dispatcher->*Work)();
+        };
+    }
+
+    // Idle threads above the minimum exit, one at a time. The exiting thread moves its handle out of its slot
+    // and joins the thread that retired before it: producers never join threads, and stop() joins the last one.
+    // Skipped while the pool is locked, stop() may be joining this very thread.
+    auto try_retire() -> bool
+    {
+        std::unique_lock pool_lock(_pool_mutex, std::try_to_lock);
+        if (!pool_lock.owns_lock())
+            return false;
+
+        auto running_threads = _running_threads.load();
+        while (running_threads > _min_threads)
+        {
+            if (_running_threads.compare_exchange_weak(running_threads, running_threads - 1))
+            {
+                if (_this_thread_pinned)
+                    _pinned_threads.fetch_sub(1);
+                _active_workers[_this_thread_worker] = false;
+                auto retired_thread = std::exchange(_retired_thread, std::move(_dispatcher_threads[_this_thread_worker]));
+                pool_lock.unlock();
+
+                if (retired_thread.joinable())
+                    retired_thread.join();
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    template <typename... Args, typename HandlerT>
+    auto add_event_handler(event_id_t event_handler_id, std::string_view event_name, HandlerT&& event_handler, const handler_options& options) -> unsigned long
+    {
+        using ResultT = std::invoke_result_t<HandlerT, Args...>;
+        using WrapperT = typename evds::details::function_traits<HandlerT>::wrapper_t;
+        static_assert(std::is_same_v<void, ResultT> || std::is_same_v<task, ResultT>, "\nevent_handler must return void or evds::task!");
+        static_assert(!std::is_same_v<task, ResultT> || evds::details::function_traits<HandlerT>::takes_values,
+            "\nasynchronous event_handler must take its arguments by value!"
+            "\nreferences into the event payload do not outlive the first suspension of the coroutine");
+        static_assert(std::is_same_v<std::function<ResultT(std::decay_t<Args>...)>, WrapperT>, 
+            "\nevent_handler arguments mismatch in add_handler()!"
+            "\nplease match your handler arguments (input parameters) with your declaration (template specification)");
+
+        const auto handler_id = _handler_ids.fetch_add(1, std::memory_order_relaxed) + 1;
+        std::shared_ptr<base_handler_t> handler = std::make_unique<handler_t<std::decay_t<Args>...>>(handler_id, options, make_handler<Args...>(std::forward<HandlerT>(event_handler)));
+
+        std::unique_lock handlers_lock(_handlers_mutex);
+        const auto channel = get_channel<Args...>(event_handler_id, event_name);
+        const auto& current = channel->current().event;
+        auto event_handlers = current.handlers ? live_handlers(*current.handlers) : std::make_shared<handlers_t>();
+        event_handlers->push_back(handler);
+        _handlers_index.emplace(handler_id, handler_entry_t{channel, std::move(handler)});
+        publish(*channel, std::move(event_handlers), current.options);
+        channel->tombstones = 0;
+        return handler_id;
+    }
+
+    // Requires _handlers_mutex. Copies the handlers list without its tombstones.
+    static auto live_handlers(const handlers_t& handlers) -> std::shared_ptr<handlers_t>
+    {
+        auto live_handlers = std::make_shared<handlers_t>();
+        live_handlers->reserve(handlers.size());
+        std::ranges::copy_if(handlers, std::back_inserter(*live_handlers), [](auto&& h){ return !h->removed.load(std::memory_order_relaxed); });
+        return live_handlers;
+    }
+
+    // Handlers receive const references into the shared payload. The few taking mutable
+    // or rvalue references get their own copy of the arguments instead.
+    // Asynchronous handlers are started and left running on their own: the call returns at their first suspension.
+    template <typename... Args, typename HandlerT>
+    static auto make_handler(HandlerT&& event_handler) -> std::function<void(const std::decay_t<Args>&...)>
+    {
+        if constexpr (std::is_same_v<task, std::invoke_result_t<HandlerT, Args...>>)
+        {
+            return [h = std::forward<HandlerT>(event_handler)](const std::decay_t<Args>&... args) mutable
+            {
+                [&h](std::decay_t<Args>... copies){ std::invoke(h, std::forward<Args>(copies)...).start(); }(args...);
+            };
+        }
+        else if constexpr (std::is_invocable_v<std::decay_t<HandlerT>&, const std::decay_t<Args>&...>)
+        {
+            return std::forward<HandlerT>(event_handler);
+        }
+        else
+        {
+            return [h = std::forward<HandlerT>(event_handler)](const std::decay_t<Args>&... args) mutable
+            {
+                [&h](std::decay_t<Args>... copies){ std::invoke(h, std::forward<Args>(copies)...); }(args...);
+            };
+        }
+    }
+
+    // The first next() on an event registers a handler that hands the event arguments over to its awaiters.
+    template <typename... Args>
+    auto get_awaiters(event_id_t event_handler_id, std::string_view event_name) -> std::shared_ptr<awaiters_t<Args...>>
+    {
+        std::scoped_lock awaiters_lock(_awaiters_mutex);
+        auto& awaiters = _awaiters[event_handler_id];
+        if (!awaiters)
+        {
+            auto event_awaiters = std::make_shared<awaiters_t<Args...>>();
+            add_event_handler<Args...>(event_handler_id, event_name, [this, event_awaiters](const Args&... args)
+            {
+                resume_awaiters(*event_awaiters, args...);
+            }, {});
+            awaiters = event_awaiters;
+        }
+        return std::static_pointer_cast<awaiters_t<Args...>>(awaiters);
+    }
+
+    // Frames are destroyed unlocked: their destructors may call next().
+    void destroy_awaiters()
+    {
+        decltype(_awaiters) awaiters;
+        {
+            std::scoped_lock awaiters_lock(_awaiters_mutex);
+            awaiters.swap(_awaiters);
+        }
+        for (auto&& [event_handler_id, event_awaiters] : awaiters)
+            event_awaiters->destroy_waiting();
+    }
+
+    // Every awaiter is resumed by its own task, so that thousands of them are spread over the dispatcher threads.
+    template <typename... Args>
+    void resume_awaiters(awaiters_t<Args...>& awaiters, const Args&... args)
+    {
+        std::vector<typename awaiters_t<Args...>::waiter_t> waiting;
+        {
+            std::scoped_lock awaiters_lock(awaiters.mutex);
+            waiting.swap(awaiters.waiting);
+        }
+
+        for (auto&& waiter : waiting)
+        {
+            waiter.args->emplace(args...);
+            enqueue(event_t(resume_task_t{waiter.coroutine, waiter.owner}, _task_pool, internal_task), event_priority::normal);
+        }
+    }
+
+    template <typename... Args>
+    auto add_timer(std::chrono::steady_clock::time_point deadline, std::chrono::steady_clock::duration period, event_id_t event_handler_id, Args... args) -> timer_handle
+    {
+        return timer_handle{this, schedule_timer(deadline, period, [this, event_handler_id, args...]
+        {
+            auto event = find_event<Args...>(event_handler_id);
+            push_events<Args...>(std::move(event), route_of(event), false, args...);
+        })};
+    }
+
+    // A thread parked until a later deadline is woken up when the new timer is the next one due.
+    template <typename CallbackT>
+    auto schedule_timer(std::chrono::steady_clock::time_point deadline, std::chrono::steady_clock::duration period, CallbackT&& callback) -> std::uint64_t
+    {
+        const auto period_ticks = period > std::chrono::steady_clock::duration::zero() ? std::max<std::uint64_t>(std::chrono::ceil<std::chrono::milliseconds>(period) / timer_resolution, 1) : 0;
+        std::uint64_t timer_id = 0;
+        bool is_next = false;
+        {
+            std::scoped_lock timers_lock(_timers_mutex);
+            timer_id = _timers.add(timer_tick(deadline), period_ticks, std::forward<CallbackT>(callback));
+            const auto next_tick = _timers.next_tick();
+            is_next = next_tick < _next_timer_tick.load(std::memory_order_relaxed);
+            if (is_next)
+                _next_timer_tick = next_tick;
+        }
+
+        if (is_next)
+        {
+            {
+                std::scoped_lock dispatcher_lock(_dispatcher_mutex);
+            }
+            _dispatcher_cv.notify_one();
+            arm_timer_wake();
+        }
+        return timer_id;
+    }
+
+    auto cancel_timer(std::uint64_t timer_id) -> bool
+    {
+        std::scoped_lock timers_lock(_timers_mutex);
+        return _timers.cancel(timer_id);
+    }
+
+    // Fires the due timers. A single thread advances the wheel at a time: the others go on with their events.
+    void poll_timers()
+    {
+        if (!timers_due())
+            return;
+
+        std::vector<details::timer_wheel::callback_t> due;
+        {
+            std::unique_lock timers_lock(_timers_mutex, std::try_to_lock);
+            if (!timers_lock.owns_lock())
+                return;
+
+            _timers.advance(current_timer_tick(), due);
+            _next_timer_tick = _timers.next_tick();
+        }
+        arm_timer_wake();
+
+        for (auto&& callback : due)
+            (*callback)();
+    }
+
+    auto timers_due() const -> bool
+    {
+        const auto next_tick = _next_timer_tick.load(std::memory_order_relaxed);
+        return next_tick != details::timer_wheel::never && current_timer_tick() >= next_tick;
+    }
+
+    auto next_timer_at() const -> std::chrono::steady_clock::time_point
+    {
+        const auto next_tick = _next_timer_tick.load(std::memory_order_relaxed);
+        return next_tick != details::timer_wheel::never ? timer_deadline(next_tick) : std::chrono::steady_clock::time_point::max();
+    }
+
+    auto timer_deadline(std::uint64_t tick) const -> std::chrono::steady_clock::time_point
+    {
+        return _timers_epoch + static_cast<std::int64_t>(tick) * timer_resolution;
+    }
+
+    // Ticks elapsed since the dispatcher creation, rounded down: timers never fire early.
+    auto current_timer_tick() const -> std::uint64_t
+    {
+        return static_cast<std::uint64_t>((std::chrono::steady_clock::now() - _timers_epoch) / timer_resolution);
+    }
+
+    auto timer_tick(std::chrono::steady_clock::time_point deadline) const -> std::uint64_t
+    {
+        return deadline > _timers_epoch ? static_cast<std::uint64_t>(std::chrono::ceil<std::chrono::milliseconds>(deadline - _timers_epoch) / timer_resolution) : 0;
+    }
+
+    // Requires _handlers_mutex. A new channel is published with a copy of the whole table: events are registered rarely.
+    // Debug builds check that an existing channel was created for the same event, not one whose id collides.
+    template <typename... Args>
+    auto get_channel(event_id_t event_handler_id, std::string_view event_name) -> std::shared_ptr<event_channel_t>
+    {
+        const auto* channels = _channels.load(std::memory_order_relaxed);
+        if (channels)
+        {
+            const auto channel_it = channels->find(event_handler_id);
+            if (channel_it != channels->end())
+            {
+                assert(channel_it->second->name == event_name && channel_it->second->signature == details::signature<Args...>() 
+                    && "event id collision: another event was registered with the same id");
+                return channel_it->second;
+            }
+        }
+
+        auto next_channels = channels ? std::make_unique<channels_t>(*channels) : std::make_unique<channels_t>();
+        auto channel = next_channels->emplace(event_handler_id, 
+            std::make_shared<event_channel_t>(event_handler_id, event_name, details::signature<Args...>())).first->second;
+        const std::unique_ptr<const channels_t> retired{_channels.exchange(next_channels.release(), std::memory_order_seq_cst)};
+        _rcu.synchronize();
+        return channel;
+    }
+
+    // Requires _handlers_mutex.
+    void publish(event_channel_t& channel, std::shared_ptr<const handlers_t> handlers, const event_options& options)
+    {
+        published_event_t snapshot;
+        snapshot.event = {handlers, options, options.ordered ? std::optional{channel.id} : std::nullopt};
+        snapshot.event.conflation = options.conflate != conflation::none ? &channel.conflation : nullptr;
+#if defined(EVDS_ENABLE_STATS)
+        snapshot.event.counters = &channel.counters;
+#endif
+#if defined(EVDS_ENABLE_TRACING)
+        snapshot.event.id = channel.id;
+#endif
+        if (handlers && std::ranges::any_of(*handlers, &base_handler_t::inline_safe))
+        {
+            auto inline_handlers = std::make_shared<handlers_t>();
+            auto queued_handlers = std::make_shared<handlers_t>();
+            for (auto&& h : *handlers)
+                (h->inline_safe ? inline_handlers : queued_handlers)->push_back(h);
+
+            snapshot.inline_handlers = std::move(inline_handlers);
+            snapshot.queued_event = snapshot.event;
+            snapshot.queued_event.handlers = std::move(queued_handlers);
+        }
+
+        const auto retired = channel.exchange(std::move(snapshot));
+        _rcu.synchronize();
+    }
+
+    template <typename... Args>
+    void configure_channel(event_id_t event_handler_id, std::string_view event_name, const event_options& options)
+    {
+        std::scoped_lock handlers_lock(_handlers_mutex);
+        const auto channel = get_channel<Args...>(event_handler_id, event_name);
+        publish(*channel, channel->current().event.handlers, options);
+    }
+
+    // Lock free: the channels table and the channel snapshots are only read inside an rcu read section.
+    // Emits only copy the handlers reference out of it, not the inline/queued split.
+    template <typename... Args>
+    auto find_event(event_id_t event_handler_id) -> event_snapshot_t
+    {
+        const auto read_guard = _rcu.read_lock();
+        const auto* published = find_published<Args...>(event_handler_id);
+        return published ? published->event : event_snapshot_t{};
+    }
+
+    auto find_event(const event_channel_t& channel) -> event_snapshot_t
+    {
+        const auto read_guard = _rcu.read_lock();
+        return channel.snapshot().event;
+    }
+
+    template <typename... Args>
+    auto find_sync_event(event_id_t event_handler_id) -> sync_event_t
+    {
+        const auto read_guard = _rcu.read_lock();
+        const auto* published = find_published<Args...>(event_handler_id);
+        return published ? sync_event_of(*published) : sync_event_t{};
+    }
+
+    auto find_sync_event(const event_channel_t& channel) -> sync_event_t
+    {
+        const auto read_guard = _rcu.read_lock();
+        return sync_event_of(channel.snapshot());
+    }
+
+    // Requires an rcu read section: the pointer is only valid inside it.
+    // Debug builds check the signature: handlers of a colliding event would be called with the wrong arguments.
+    template <typename... Args>
+    auto find_published(event_id_t event_handler_id) const -> const published_event_t*
+    {
+        const auto* channels = _channels.load(std::memory_order_seq_cst);
+        if (!channels)
+            return nullptr;
+
+        const auto channel_it = channels->find(event_handler_id);
+        if (channel_it == channels->end())
+            return nullptr;
+
+        assert(channel_it->second->signature == details::signature<Args...>() && "event id collision: the event was registered with other arguments");
+        return &channel_it->second->snapshot();
+    }
+
+    static auto sync_event_of(const published_event_t& published) -> sync_event_t
+    {
+        if (!published.inline_handlers)
+            return {published.event, nullptr};
+        return {published.queued_event, published.inline_handlers};
+    }
+
+    template <typename... Args>
+    auto emit_event(event_id_t event_handler_id, Args... args) -> bool
+    {
+        auto event = find_event<Args...>(event_handler_id);
+        return enqueue_events<Args...>(std::move(event), route_of(event), std::move(args)...);
+    }
+
+    template <typename T, typename... CtorArgs>
+    auto emplace_event(event_id_t event_handler_id, CtorArgs&&... ctor_args) -> bool
+    {
+        auto event = find_event<T>(event_handler_id);
+        return push_events<T>(std::move(event), route_of(event), true, std::forward<CtorArgs>(ctor_args)...) == emit_status::queued;
+    }
+
+    template <typename... Args>
+    auto enqueue_events(event_snapshot_t&& event, const route_t& route, Args... args) -> bool
+    {
+        return push_events<Args...>(std::move(event), route, true, std::move(args)...) == emit_status::queued;
+    }
+
+    // The lane capacity is checked before the payload is built: overflowing emits cost no allocation.
+    // The snapshot handlers reference moves into the payload: only its plain fields are read afterwards.
+    template <typename... Args, typename... CtorArgs>
+    auto push_events(event_snapshot_t&& event, const route_t& route, bool can_block, CtorArgs&&... ctor_args) -> emit_status
+    {
+        auto status = emit_status::no_handlers;
+        if (event.handlers && !event.handlers->empty())
+        {
+            if (event.conflation)
+            {
+                status = conflate<Args...>(std::move(event), route, std::forward<CtorArgs>(ctor_args)...);
+            }
+            else
+            {
+                status = admit(lane_index(route.priority), can_block);
+                if (status == emit_status::queued)
+                    make_events<Args...>(std::move(event), route.priority, [this, &route](event_t&& e){ push_routed(std::move(e), route); }, std::forward<CtorArgs>(ctor_args)...);
+            }
+        }
+
+#if defined(EVDS_ENABLE_STATS)
+        counters_of(event).count_emit(status);
+#endif
+        return status;
+    }
+
+    // The emit payload becomes the pending one of the event. Coalesced emits report queued: their newest payload is.
+    // A conflated event holds one lane slot at most: its flush task bypasses the lane capacity.
+    template <typename... Args, typename... CtorArgs>
+    auto conflate(event_snapshot_t&& event, const route_t& route, CtorArgs&&... ctor_args) -> emit_status
+    {
+        auto payload = std::allocate_shared<event_payload_t<Args...>>(
+            details::pool_allocator<event_payload_t<Args...>>(_task_pool), std::move(event.handlers), std::forward<CtorArgs>(ctor_args)...);
+        on_emit(*payload, event);
+
+        auto& slot = *event.conflation;
+        {
+            std::scoped_lock slot_lock(slot.mutex);
+            if (slot.payload)
+            {
+                _coalesced_emits.fetch_add(1, std::memory_order_relaxed);
+#if defined(EVDS_ENABLE_STATS)
+                counters_of(event).count_coalesced();
+#endif
+            }
+            slot.payload = std::move(payload);
+            slot.route = route;
+
+            bool is_flush_due = event.options.conflate == conflation::latest;
+            if (event.options.conflate == conflation::debounce)
+            {
+                if (slot.timer_id != 0)
+                    cancel_timer(slot.timer_id);
+                start_window<Args...>(slot, event.options);
+            }
+            else if (event.options.conflate == conflation::throttle && slot.timer_id == 0)
+            {
+                is_flush_due = true;
+                start_window<Args...>(slot, event.options);
+            }
+
+            if (!is_flush_due || slot.is_queued)
+                return emit_status::queued;
+            slot.is_queued = true;
+        }
+
+        push_flush<Args...>(slot, route);
+        return emit_status::queued;
+    }
+
+    // Requires the slot mutex. Debounce: the window end queues the pending payload.
+    // Throttle: it queues the payload that came during the window, if any, and starts the next window.
+    template <typename... Args>
+    void start_window(conflation_slot_t& slot, const event_options& options)
+    {
+        slot.timer_id = schedule_timer(std::chrono::steady_clock::now() + options.conflation_window, {}, [this, &slot, options, window_id = ++slot.window_id]
+        {
+            route_t route;
+            {
+                std::scoped_lock slot_lock(slot.mutex);
+                if (slot.window_id != window_id)
+                    return;
+
+                slot.timer_id = 0;
+                if (!slot.payload)
+                    return;
+
+                if (options.conflate == conflation::throttle)
+                    start_window<Args...>(slot, options);
+
+                if (slot.is_queued)
+                    return;
+                slot.is_queued = true;
+                route = slot.route;
+            }
+            push_flush<Args...>(slot, route);
+        });
+    }
+
+    template <typename... Args>
+    void push_flush(conflation_slot_t& slot, const route_t& route)
+    {
+        push_routed(event_t(flush_task_t<Args...>{&slot}, _task_pool, internal_task), route);
+    }
+
+    // Queued handlers get their own copy of the arguments, inline ones read the caller's.
+    template <typename... Args>
+    auto dispatch_sync(sync_event_t&& event, Args... args) -> bool
+    {
+        auto& queued_event = event.queued_event;
+        if (!event.inline_handlers)
+            return push_events<Args...>(std::move(queued_event), route_of(queued_event), true, std::move(args)...) == emit_status::queued;
+
+        if (queued_event.handlers->empty())
+        {
+#if defined(EVDS_ENABLE_STATS)
+            counters_of(queued_event).count_emit(emit_status::queued);
+#endif
+        }
+        else
+        {
+            push_events<Args...>(std::move(queued_event), route_of(queued_event), true, std::as_const(args)...);
+        }
+
+        for (auto&& h : *event.inline_handlers)
+            static_cast<const handler_t<Args...>*>(h.get())->call(args...);
+
+        return true;
+    }
+
+    template <typename... Args>
+    static void call_handlers(const event_payload_t<Args...>& payload, std::size_t first, std::size_t last)
+    {
+        payload.args.apply([&payload, first, last](const Args&... args)
+        {
+            auto started = on_pickup(payload);
+            for (auto i = first; i < last; ++i)
+            {
+                const auto& h = (*payload.handlers)[i];
+                static_cast<const handler_t<Args...>*>(h.get())->call(args...);
+                started = on_handler_done(payload, *h, started);
+            }
+        });
+    }
+
+    // Instrumentation hooks: they compile to nothing unless EVDS_ENABLE_STATS or EVDS_ENABLE_TRACING is defined.
+    template <typename... Args>
+    void on_emit([[maybe_unused]] event_payload_t<Args...>& payload, [[maybe_unused]] const event_snapshot_t& event)
+    {
+#if defined(EVDS_ENABLE_STATS) || defined(EVDS_ENABLE_TRACING)
+        payload.queued_at = std::chrono::steady_clock::now();
+#endif
+#if defined(EVDS_ENABLE_STATS)
+        payload.counters = &counters_of(event);
+#endif
+#if defined(EVDS_ENABLE_TRACING)
+        payload.trace = &_trace;
+        payload.event_id = event.id;
+        payload.emit_id = _trace.record_emit(event.id, payload.queued_at);
+#endif
+    }
+
+    template <typename... Args>
+    static auto on_pickup([[maybe_unused]] const event_payload_t<Args...>& payload) -> std::chrono::steady_clock::time_point
+    {
+#if defined(EVDS_ENABLE_STATS) || defined(EVDS_ENABLE_TRACING)
+        const auto started = std::chrono::steady_clock::now();
+#if defined(EVDS_ENABLE_STATS)
+        payload.counters->record_queueing(started - payload.queued_at);
+#endif
+#if defined(EVDS_ENABLE_TRACING)
+        payload.trace->record_pickup(payload.event_id, payload.emit_id, started);
+#endif
+        return started;
+#else
+        return {};
+#endif
+    }
+
+    // Returns when the handler finished, which is when the next one of the task starts.
+    template <typename... Args>
+    static auto on_handler_done([[maybe_unused]] const event_payload_t<Args...>& payload, [[maybe_unused]] const base_handler_t& h, 
+        std::chrono::steady_clock::time_point started) -> std::chrono::steady_clock::time_point
+    {
+#if defined(EVDS_ENABLE_STATS) || defined(EVDS_ENABLE_TRACING)
+        const auto finished = std::chrono::steady_clock::now();
+#if defined(EVDS_ENABLE_STATS)
+        payload.counters->record_handler(finished - started);
+#endif
+#if defined(EVDS_ENABLE_TRACING)
+        payload.trace->record_handler(payload.event_id, payload.emit_id, h.id, started, finished);
+#endif
+        return finished;
+#else
+        return started;
+#endif
+    }
+
+    // Turns one emit into queued tasks according to the event dispatch mode and hands them over to push.
+    // The tasks are tagged with the lane they count against. The payload is built in place from ctor_args, once per emit.
+    // Payload blocks and oversized tasks come from the dispatcher slab pool: once it is warmed up,
+    // an emit does not touch the global allocator.
+    template <typename... Args, typename PushT, typename... CtorArgs>
+    auto make_events(event_snapshot_t&& event, event_priority priority, PushT&& push, CtorArgs&&... ctor_args) -> bool
+    {
+        const auto tag = emit_task_tag(lane_index(priority));
+        const auto& options = event.options;
+        if (!event.handlers || event.handlers->empty())
+            return false;
+
+        const auto handlers_count = event.handlers->size();
+        auto shared_payload = std::allocate_shared<event_payload_t<Args...>>(
+            details::pool_allocator<event_payload_t<Args...>>(_task_pool), std::move(event.handlers), std::forward<CtorArgs>(ctor_args)...);
+        on_emit(*shared_payload, event);
+        const std::shared_ptr<const event_payload_t<Args...>> payload = std::move(shared_payload);
+
+        if (options.dispatch == dispatch_mode::fan_out)
+        {
+            push(event_t([payload]{ call_handlers<Args...>(*payload, 0, payload->handlers->size()); }, _task_pool, tag));
+            return true;
+        }
+
+        const auto chunk_size = options.dispatch == dispatch_mode::per_handler ? 1 : std::max<std::size_t>(options.chunk_size, 1);
+        for (std::size_t first = 0; first < handlers_count; first += chunk_size)
+        {
+            push(event_t([payload, first, last = std::min(first + chunk_size, handlers_count)]
+            {
+                call_handlers<Args...>(*payload, first, last);
+            }, _task_pool, tag));
+        }
+
+        return true;
+    }
+
+    static constexpr auto lane_index(event_priority priority) -> std::size_t
+    {
+        return static_cast<std::size_t>(priority);
+    }
+
+    // Tasks of emitted events are tagged with their lane, internal ones with internal_task.
+    static constexpr auto emit_task_tag(std::size_t lane) -> std::uint8_t
+    {
+        return static_cast<std::uint8_t>(lane + 1);
+    }
+
+    static auto is_emit_task(const event_t& event) -> bool
+    {
+        return event.tag() != internal_task;
+    }
+
+    static auto emit_task_lane(const event_t& event) -> std::size_t
+    {
+        return static_cast<std::size_t>(event.tag() - 1);
+    }
+
+#if defined(EVDS_ENABLE_STATS)
+    // Emits of events that were never registered have no channel: they are only accounted in the totals.
+    auto counters_of(const event_snapshot_t& event) -> details::event_counters&
+    {
+        return event.counters ? *event.counters : _untracked_counters;
+    }
+#endif
+
+    static auto route_of(const event_snapshot_t& event) -> route_t
+    {
+        return {event.options.priority, event.strand};
+    }
+
+    auto strands_stripe(std::uint64_t key) -> strands_stripe_t&
+    {
+        return _strand_stripes[static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) % strand_stripes_count];
+    }
+
+    void push_routed(event_t&& event, const route_t& route)
+    {
+        if (route.strand)
+            enqueue_strand(*route.strand, std::move(event), route.priority);
+        else
+            enqueue(std::move(event), route.priority);
+    }
+
+    // Strand tasks wait in the strand, not in the lanes, but still hold room in the lane of their emit until they run.
+    void enqueue_strand(std::uint64_t key, event_t&& event, event_priority priority)
+    {
+        auto& stripe = strands_stripe(key);
+        _pending_tasks.fetch_add(1);
+        if (is_emit_task(event))
+            _lane_depths[emit_task_lane(event)].emit_tasks.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::scoped_lock stripe_lock(stripe.mutex);
+            auto strand_it = stripe.strands.find(key);
+            const bool is_new = strand_it == stripe.strands.end();
+            if (is_new && stripe.spare)
+            {
+                stripe.spare.key() = key;
+                strand_it = stripe.strands.insert(std::move(stripe.spare)).position;
+            }
+            else if (is_new)
+            {
+                strand_it = stripe.strands.try_emplace(key).first;
+            }
+
+            strand_it->second.tasks.push_back(std::move(event));
+            if (!is_new)
+                return;
+        }
+
+        enqueue(event_t([this, key, priority]{ drain_strand(key, priority); }, _task_pool, internal_task), priority);
+    }
+
+    // Runs a bounded number of strand tasks, then queues itself again so a busy strand does not hog its thread.
+    void drain_strand(std::uint64_t key, event_priority priority)
+    {
+        auto& stripe = strands_stripe(key);
+        for (std::size_t i = 0; i < strand_drain_budget; ++i)
+        {
+            event_t event;
+            {
+                std::scoped_lock stripe_lock(stripe.mutex);
+                const auto strand_it = stripe.strands.find(key);
+                auto& tasks = strand_it->second.tasks;
+                if (tasks.empty())
+                {
+                    stripe.spare = stripe.strands.extract(strand_it);
+                    return;
+                }
+
+                event = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            if (is_emit_task(event))
+                release_emit_task(emit_task_lane(event));
+            event();
+            task_done();
+        }
+
+        enqueue(event_t([this, key, priority]{ drain_strand(key, priority); }, _task_pool, internal_task), priority);
+    }
+
+    void enqueue(event_t&& event, event_priority priority)
+    {
+        _pending_tasks.fetch_add(1);
+        push_lane(lane_index(priority), std::span(&event, 1));
+        wake_dispatchers(1);
+        maybe_grow();
+    }
+
+    void enqueue_bulk(std::vector<event_t>& events, event_priority priority)
+    {
+        if (events.empty())
+            return;
+
+        _pending_tasks.fetch_add(events.size());
+        push_lane(lane_index(priority), events);
+        wake_dispatchers(events.size());
+        maybe_grow();
+    }
+
+    // Lane depths are raised before pushing and lowered after popping, so they never go below the real size.
+    void push_lane(std::size_t lane, std::span<event_t> events)
+    {
+        auto& depth = _lane_depths[lane];
+        if (const auto emit_tasks = static_cast<std::size_t>(std::ranges::count_if(events, is_emit_task)))
+            depth.emit_tasks.fetch_add(emit_tasks, std::memory_order_relaxed);
+        depth.events.fetch_add(events.size(), std::memory_order_relaxed);
+
+        const auto pushed = depth.spilled.load(std::memory_order_relaxed) == 0 ? _events_queues[lane].try_push_bulk(events) : 0;
+        if (pushed < events.size())
+            spill(lane, events.subspan(pushed));
+    }
+
+    void spill(std::size_t lane, std::span<event_t> events)
+    {
+        auto& lane_spill = _lane_spills[lane];
+        std::scoped_lock spill_lock(lane_spill.mutex);
+        for (auto&& event : events)
+            lane_spill.tasks.push_back(std::move(event));
+        _lane_depths[lane].spilled.fetch_add(events.size(), std::memory_order_relaxed);
+    }
+
+    // The spill only holds tasks pushed after those of the lane queue: it is popped once the queue is empty.
+    auto try_pop_lane(std::size_t lane, event_t& event) -> bool
+    {
+        auto& depth = _lane_depths[lane].events;
+        if (depth.load(std::memory_order_relaxed) == 0 || (!_events_queues[lane].try_pop(event) && !try_pop_spill(lane, event)))
+            return false;
+
+        depth.fetch_sub(1, std::memory_order_relaxed);
+        if (is_emit_task(event))
+            release_emit_task(lane);
+        return true;
+    }
+
+    // Tasks of emitted events leave the lane capacity when popped from their lane queue or their strand.
+    void release_emit_task(std::size_t lane)
+    {
+        _lane_depths[lane].emit_tasks.fetch_sub(1, std::memory_order_relaxed);
+        if (_options.lane_capacity != 0)
+            wake_producers();
+    }
+
+    auto try_pop_spill(std::size_t lane, event_t& event) -> bool
+    {
+        auto& spilled = _lane_depths[lane].spilled;
+        if (spilled.load(std::memory_order_relaxed) == 0)
+            return false;
+
+        auto& lane_spill = _lane_spills[lane];
+        std::scoped_lock spill_lock(lane_spill.mutex);
+        if (lane_spill.tasks.empty())
+            return false;
+
+        event = std::move(lane_spill.tasks.front());
+        lane_spill.tasks.pop_front();
+        spilled.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Applies the overflow policy when the lane is full: emit_status::queued means the events may be pushed.
+    // Only tasks of emitted events count, internal tasks are never admitted nor evicted.
+    // Dispatcher threads never block on their own dispatcher, they would wait for themselves: their emits go over capacity.
+    auto admit(std::size_t lane, bool can_block) -> emit_status
+    {
+        const auto capacity = _options.lane_capacity;
+        auto& depth = _lane_depths[lane].emit_tasks;
+        if (capacity == 0 || depth.load(std::memory_order_relaxed) < capacity)
+            return emit_status::queued;
+
+        switch (_options.overflow)
+        {
+        case overflow_policy::drop_newest:
+            _overflow_counters.dropped_newest.fetch_add(1, std::memory_order_relaxed);
+            return emit_status::dropped;
+
+        case overflow_policy::drop_oldest:
+            if (evict_oldest(lane, capacity))
+                return emit_status::queued;
+
+            _overflow_counters.dropped_newest.fetch_add(1, std::memory_order_relaxed);
+            return emit_status::dropped;
+
+        case overflow_policy::reject:
+            _overflow_counters.rejected.fetch_add(1, std::memory_order_relaxed);
+            return emit_status::rejected;
+
+        case overflow_policy::block:
+            break;
+        }
+
+        if (!can_block)
+        {
+            _overflow_counters.rejected.fetch_add(1, std::memory_order_relaxed);
+            return emit_status::rejected;
+        }
+
+        if (_this_thread_dispatcher == this)
+            return emit_status::queued;
+
+        std::unique_lock producers_lock(_producers_mutex);
+        _blocked_producers.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const bool has_room = _producers_cv.wait_for(producers_lock, _options.block_timeout, [&depth, capacity]
+        { 
+            return depth.load(std::memory_order_relaxed) < capacity; 
+        });
+        _blocked_producers.fetch_sub(1);
+
+        if (has_room)
+            return emit_status::queued;
+
+        _overflow_counters.timed_out.fetch_add(1, std::memory_order_relaxed);
+        return emit_status::dropped;
+    }
+
+    // Internal tasks met on the way are pushed back behind the lane: they stay pending meanwhile.
+    // Strand tasks are not evicted: false when they alone fill the lane, the new event is then dropped instead.
+    auto evict_oldest(std::size_t lane, std::size_t capacity) -> bool
+    {
+        std::vector<event_t> internal_tasks;
+        for (event_t event; _lane_depths[lane].emit_tasks.load(std::memory_order_relaxed) >= capacity && try_pop_lane(lane, event); event.reset())
+        {
+            if (!is_emit_task(event))
+            {
+                internal_tasks.push_back(std::move(event));
+                continue;
+            }
+
+            _overflow_counters.dropped_oldest.fetch_add(1, std::memory_order_relaxed);
+            task_done();
+        }
+
+        if (!internal_tasks.empty())
+            push_lane(lane, internal_tasks);
+        return _lane_depths[lane].emit_tasks.load(std::memory_order_relaxed) < capacity;
+    }
+
+    // Tasks are counted from before they are pushed until they have run or have been discarded.
+    // The last one wakes wait_idle() callers, only when there are some.
+    void task_done(std::size_t tasks_count = 1)
+    {
+        if (tasks_count == 0 || _pending_tasks.fetch_sub(tasks_count) != tasks_count || _idle_waiters.load() == 0)
+            return;
+
+        {
+            std::scoped_lock idle_lock(_idle_mutex);
+        }
+        _idle_cv.notify_all();
+    }
+
+    void wake_producers()
+    {
+        // Pairs with the fence in admit(), as wake_dispatchers() does with run().
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_blocked_producers.load(std::memory_order_relaxed) == 0)
+            return;
+
+        {
+            std::scoped_lock producers_lock(_producers_mutex);
+        }
+        _producers_cv.notify_all();
+    }
+
+    // Strict: first non empty lane. Weighted: first non empty lane with credits left, 
+    // credits are refilled from the lane weights once every non empty lane has run out.
+    auto try_pop(event_t& event, lane_credits_t& credits) -> bool
+    {
+        if (_options.scheduling == lane_scheduling::weighted)
+        {
+            for (std::size_t lane = 0; lane < event_priorities_count; ++lane)
+            {
+                if (credits[lane] > 0 && try_pop_lane(lane, event))
+                {
+                    --credits[lane];
+                    return true;
+                }
+            }
+
+            credits = _options.lane_weights;
+        }
+
+        for (std::size_t lane = 0; lane < event_priorities_count; ++lane)
+        {
+            if (try_pop_lane(lane, event))
+            {
+                credits[lane] -= credits[lane] > 0 ? 1 : 0;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    auto queued_events() const -> std::size_t
+    {
+        std::size_t events_count = 0;
+        for (auto&& lane_depth : _lane_depths)
+            events_count += lane_depth.events.load(std::memory_order_relaxed);
+        return events_count;
+    }
+
+    void wake_dispatchers(std::size_t events_count)
+    {
+        // Pairs with the fence in run(): either the parked thread sees the new events 
+        // or we see it parked and wake it up under the dispatcher mutex.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_uses_executor.load(std::memory_order_acquire))
+        {
+            post_drains(events_count);
+            return;
+        }
+
+        const auto parked_threads = _parked_threads.load(std::memory_order_relaxed);
+        if (parked_threads == 0 || events_count == 0)
+            return;
+
+        {
+            std::scoped_lock dispatcher_lock(_dispatcher_mutex);
+        }
+
+        if (events_count >= parked_threads)
+        {
+            _dispatcher_cv.notify_all();
+            return;
+        }
+
+        for (std::size_t i = 0; i < events_count; ++i)
+            _dispatcher_cv.notify_one();
     }
 
-private:
     std::atomic_bool _is_running;
     std::mutex _is_running_mutex;
-    std::unordered_map<std::string, std::vector<std::shared_ptr<base_handler_t>>> _handlers;
+    std::atomic<const channels_t*> _channels{nullptr};
     std::mutex _handlers_mutex;
-    std::queue<event_t> _events_queue;
-    std::mutex _events_mutex;
+    std::unordered_map<unsigned long, handler_entry_t> _handlers_index;
+    std::atomic<unsigned long> _handler_ids{0};
+    std::mutex _awaiters_mutex;
+    std::unordered_map<event_id_t, std::shared_ptr<base_awaiters_t>> _awaiters;
+    details::rcu_domain _rcu;
+    dispatcher_options _options;
+    details::slab_pool _task_pool;
+    std::array<events_queue_t, event_priorities_count> _events_queues;
+    std::array<lane_depth_t, event_priorities_count> _lane_depths;
+    std::array<lane_spill_t, event_priorities_count> _lane_spills;
+    std::array<strands_stripe_t, strand_stripes_count> _strand_stripes;
     std::vector<std::thread> _dispatcher_threads;
+    std::unique_ptr<std::atomic_bool[]> _active_workers;
+    std::mutex _pool_mutex;
+    start_options _start_options;
+    std::chrono::steady_clock::time_point _last_pool_change;
+    std::atomic<std::chrono::steady_clock::time_point> _overloaded_since{not_overloaded};
+    std::thread _retired_thread; // last thread that left the pool, not joined yet
+    unsigned int _min_threads = 0;
+    std::atomic<unsigned int> _max_threads{0};
+    std::atomic<unsigned int> _running_threads{0};
+    std::atomic<std::size_t> _grow_queue_depth{0};
+    std::atomic<unsigned int> _pinned_threads{0};
+    wait_strategy _wait_strategy = wait_strategy::blocking;
+    unsigned int _spin_iterations = 1;
+    std::mutex _dispatcher_mutex;
     std::condition_variable _dispatcher_cv;
-    static unsigned long handler_id;
+    std::atomic<unsigned int> _parked_threads{0};
+    std::mutex _producers_mutex;
+    std::condition_variable _producers_cv;
+    std::atomic<unsigned int> _blocked_producers{0};
+    overflow_counters_t _overflow_counters;
+    std::atomic<std::size_t> _coalesced_emits{0};
+    alignas(details::cache_line_size) std::atomic<std::size_t> _pending_tasks{0};
+    std::atomic<unsigned int> _idle_waiters{0};
+    std::mutex _idle_mutex;
+    std::condition_variable _idle_cv;
+    std::mutex _timers_mutex;
+    details::timer_wheel _timers;
+    const std::chrono::steady_clock::time_point _timers_epoch = std::chrono::steady_clock::now();
+    std::atomic<std::uint64_t> _next_timer_tick{details::timer_wheel::never};
+    details::any_executor _executor;
+    std::shared_ptr<executor_link_t> _executor_link;
+    unsigned int _executor_concurrency = 0;
+    std::atomic_bool _uses_executor{false};
+    std::atomic<unsigned int> _active_drains{0};
+    std::atomic<std::uint64_t> _armed_timer_tick{details::timer_wheel::never};
+#if defined(EVDS_ENABLE_STATS)
+    details::event_counters _untracked_counters;
+#endif
+#if defined(EVDS_ENABLE_TRACING)
+    details::trace_log _trace;
+#endif
+    static inline thread_local const basic_event_dispatcher* _this_thread_dispatcher = nullptr;
+    static inline thread_local std::size_t _this_thread_worker = 0;
+    static inline thread_local bool _this_thread_pinned = false;
 };
 
-unsigned long event_dispatcher::handler_id = 0;
+using event_dispatcher = basic_event_dispatcher<>;
 
 }
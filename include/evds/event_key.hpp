@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace evds::details
+{
+inline constexpr std::uint64_t fnv_offset_basis = 14695981039346656037ull;
+inline constexpr std::uint64_t fnv_prime = 1099511628211ull;
+
+constexpr auto fnv1a(std::string_view str, std::uint64_t hash = fnv_offset_basis) -> std::uint64_t
+{
+    for (const char c : str)
+    {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= fnv_prime;
+    }
+    return hash;
+}
+
+template <typename T>
+constexpr auto type_name() -> std::string_view
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return __FUNCSIG__;
+#else
+    return __PRETTY_FUNCTION__;
+#endif
+}
+
+// Types are folded one after the other (with a separator), so (int, float) and (float, int) hash differently.
+template <typename... Args>
+constexpr auto signature_hash(std::uint64_t hash) -> std::uint64_t
+{
+    ((hash = fnv1a(type_name<std::decay_t<Args>>(), fnv1a("|", hash))), ...);
+    return hash;
+}
+
+// The full signature the id is hashed from: two events only share a channel when both their names and signatures match.
+template <typename... Args>
+auto signature() -> std::string_view
+{
+    static const std::string signature = (std::string{} + ... + (std::string{type_name<std::decay_t<Args>>()} + "|"));
+    return signature;
+}
+
+}
+
+namespace evds
+{
+using event_id_t = std::uint64_t;
+
+template <typename... Args>
+constexpr auto make_event_id(std::string_view event_name) -> event_id_t
+{
+    return details::signature_hash<Args...>(details::fnv1a(event_name));
+}
+
+template <std::size_t N>
+struct fixed_string
+{
+    constexpr fixed_string(const char (&str)[N])
+    {
+        std::copy_n(str, N, value);
+    }
+
+    constexpr auto view() const -> std::string_view
+    {
+        return {value, N - 1};
+    }
+
+    char value[N];
+};
+
+template <typename... Args>
+struct event_key
+{
+    constexpr explicit event_key(std::string_view event_name) : name{event_name}, id{make_event_id<Args...>(event_name)} {}
+
+    std::string_view name;
+    event_id_t id;
+};
+
+}
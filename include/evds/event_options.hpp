@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace evds
+{
+enum class dispatch_mode
+{
+    per_handler, // one queued task per handler: handlers of a single emit run in parallel
+    fan_out,     // one queued task per emit: handlers run one after the other on the same dispatcher thread
+    chunked      // one queued task per chunk_size handlers, all sharing a single copy of the payload
+};
+
+enum class event_priority
+{
+    high,
+    normal,
+    low
+};
+
+inline constexpr std::size_t event_priorities_count = 3;
+
+// Conflated events only keep their newest payload: handlers run one after the other on it, in a single task.
+// That task bypasses the lane capacity: a conflated event holds one lane slot at most.
+enum class conflation
+{
+    none,     // every emit is queued
+    latest,   // an emit replaces the payload of the previous one, as long as it is still queued
+    debounce, // emits are held until none came for conflation_window, then the newest one is queued
+    throttle  // the newest emit is queued at most once per conflation_window: the first one right away
+};
+
+struct event_options
+{
+    dispatch_mode dispatch = dispatch_mode::per_handler;
+    std::size_t chunk_size = 4;
+    event_priority priority = event_priority::normal; // lane used when emit() is not given a priority
+    bool ordered = false; // emits of the event run one after the other, in emit order
+    conflation conflate = conflation::none;
+    std::chrono::milliseconds conflation_window{0}; // debounce and throttle only
+};
+
+// Emits sharing a strand key run one after the other, in emit order, whatever their event.
+struct strand_key
+{
+    std::uint64_t value;
+};
+
+struct handler_options
+{
+    bool inline_safe = false; // emit_sync() may run the handler directly on the emitting thread
+};
+
+enum class lane_scheduling
+{
+    strict,  // always drain higher priority lanes first
+    weighted // serve up to lane_weights[lane] events per lane and round, higher priority first
+};
+
+enum class overflow_policy
+{
+    block,       // emit() waits up to block_timeout for room, try_emit() rejects
+    drop_newest, // the new event is discarded
+    drop_oldest, // the oldest queued events of the lane are discarded to make room (internal tasks, e.g. coroutine resumes, are kept;
+                 // ordered events waiting in their strand are kept too, and the new event is dropped when they fill the lane)
+    reject       // the new event is refused
+};
+
+struct dispatcher_options
+{
+    lane_scheduling scheduling = lane_scheduling::strict;
+    std::array<std::size_t, event_priorities_count> lane_weights = {8, 4, 1};
+    std::size_t lane_capacity = 0; // queued events per lane, checked once per emit or emit_batch() payload (once per lane for a batch). 0 is unbounded
+    overflow_policy overflow = overflow_policy::block;
+    std::chrono::milliseconds block_timeout{1000};
+};
+
+enum class emit_status
+{
+    queued,
+    no_handlers,
+    dropped,  // discarded on a full lane: drop_newest, or block timed out
+    rejected  // refused on a full lane: reject, or block from try_emit()
+};
+
+struct overflow_stats
+{
+    std::size_t dropped_newest = 0; // emits
+    std::size_t dropped_oldest = 0; // queued events
+    std::size_t rejected = 0;       // emits
+    std::size_t timed_out = 0;      // emits
+};
+
+enum class wait_strategy
+{
+    blocking,       // park on a condition variable as soon as the queues are empty
+    spin_then_park, // poll for a while then park, the polling budget adapts to how often it pays off
+    busy_poll       // never park: lowest latency, one core per dispatcher thread
+};
+
+enum class drain_policy
+{
+    discard, // events still queued on stop() are dropped
+    drain    // events still queued on stop() are handled first, within a timeout
+};
+
+// Pinned threads reserve their work-stealing deque themselves, so that it is first touched on their NUMA node.
+// The rest of the dispatcher storage is not placed: ring and mutex queues land where the dispatcher is constructed,
+// task slab chunks where the emitting thread first needs them.
+struct start_options
+{
+    unsigned int threads = 1;                        // clamped to [1, hardware_concurrency()]
+    std::vector<std::vector<unsigned int>> cpu_sets; // dispatcher thread i is pinned to cpu_sets[i % size()], none when empty
+    std::string thread_name = "evds";                // threads are named "<thread_name>-<i>", unnamed when empty
+    wait_strategy wait = wait_strategy::blocking;
+    unsigned int spin_iterations = 4096;             // max polls before parking (spin_then_park) or yielding (busy_poll)
+    unsigned int max_threads = 0;                    // elastic pool when above threads (not clamped): threads are added under load
+    std::size_t grow_queue_depth = 64;               // queued events per running thread above which a thread is added
+    std::chrono::milliseconds grow_interval{1};      // how long the queue must stay above that depth before a thread is added
+    std::chrono::milliseconds idle_timeout{5000};    // added threads parked for that long exit
+};
+
+}
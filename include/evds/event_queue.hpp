@@ -0,0 +1,482 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace evds::details
+{
+inline constexpr std::size_t cache_line_size = 64;
+
+// Tells the core we are spinning: saves power and frees pipeline resources for the sibling hyper-thread.
+inline void cpu_relax() noexcept
+{
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+    __asm__ __volatile__("yield");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#endif
+}
+
+// Spreads threads over striped structures (pools, counters) without any registration.
+inline auto this_thread_hash() -> std::size_t
+{
+    static thread_local const std::size_t hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return hash;
+}
+
+// Unbounded FIFO over a power of two array that only grows: once warmed up, pushing never allocates
+// (std::deque keeps allocating and releasing its blocks as the queue moves forward).
+template <typename T>
+class circular_buffer
+{
+public:
+    auto empty() const -> bool
+    {
+        return _head == _tail;
+    }
+
+    auto size() const -> std::size_t
+    {
+        return _tail - _head;
+    }
+
+    void push_back(T&& item)
+    {
+        if (size() == _items.size())
+            grow(std::max<std::size_t>(_items.size() * 2, 16));
+
+        _items[_tail++ & (_items.size() - 1)] = std::move(item);
+    }
+
+    auto front() -> T&
+    {
+        return _items[_head & (_items.size() - 1)];
+    }
+
+    auto back() -> T&
+    {
+        return _items[(_tail - 1) & (_items.size() - 1)];
+    }
+
+    void pop_front()
+    {
+        front() = T{};
+        ++_head;
+    }
+
+    void pop_back()
+    {
+        back() = T{};
+        --_tail;
+    }
+
+    void clear()
+    {
+        while (!empty())
+            pop_front();
+    }
+
+    // The storage is allocated and first touched by the calling thread.
+    void reserve(std::size_t capacity)
+    {
+        if (capacity > _items.size())
+            grow(std::bit_ceil(capacity));
+    }
+
+private:
+    void grow(std::size_t capacity)
+    {
+        std::vector<T> items(capacity);
+        for (std::size_t i = 0; i < size(); ++i)
+            items[i] = std::move(_items[(_head + i) & (_items.size() - 1)]);
+
+        _tail = size();
+        _head = 0;
+        _items = std::move(items);
+    }
+
+    std::vector<T> _items;
+    std::size_t _head = 0;
+    std::size_t _tail = 0;
+};
+
+template <typename T>
+class mutex_queue
+{
+public:
+    void bind_worker(std::size_t) {}
+
+    auto try_push(T&& item) -> bool
+    {
+        std::scoped_lock lock(_mutex);
+        _queue.push_back(std::move(item));
+        return true;
+    }
+
+    auto try_push_bulk(std::span<T> items) -> std::size_t
+    {
+        std::scoped_lock lock(_mutex);
+        for (auto&& item : items)
+            _queue.push_back(std::move(item));
+        return items.size();
+    }
+
+    auto try_pop(T& item) -> bool
+    {
+        std::scoped_lock lock(_mutex);
+        if (_queue.empty())
+            return false;
+
+        item = std::move(_queue.front());
+        _queue.pop_front();
+        return true;
+    }
+
+    auto empty() const -> bool
+    {
+        std::scoped_lock lock(_mutex);
+        return _queue.empty();
+    }
+
+    void clear()
+    {
+        std::scoped_lock lock(_mutex);
+        _queue.clear();
+    }
+
+private:
+    circular_buffer<T> _queue;
+    mutable std::mutex _mutex;
+};
+
+// Bounded multi-producer/multi-consumer ring buffer (D. Vyukov).
+// Every cell carries a sequence number telling producers and consumers whose turn it is,
+// so push and pop only contend on a single CAS of their own cursor.
+template <typename T, std::size_t Capacity>
+class ring_queue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "ring_queue capacity must be a power of two");
+
+    struct alignas(cache_line_size) cell_t
+    {
+        std::atomic<std::size_t> sequence;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+public:
+    ring_queue() : _cells{std::make_unique<cell_t[]>(Capacity)}
+    {
+        for (std::size_t i = 0; i < Capacity; ++i)
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~ring_queue()
+    {
+        clear();
+    }
+
+    ring_queue(const ring_queue&) = delete;
+    ring_queue(ring_queue&&) noexcept = delete;
+    ring_queue& operator=(const ring_queue&) = delete;
+    ring_queue& operator=(ring_queue&&) = delete;
+
+    void bind_worker(std::size_t) {}
+
+    auto try_push(T&& item) -> bool
+    {
+        cell_t* cell;
+        auto pos = _enqueue_pos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &_cells[pos & mask];
+            const auto sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0)
+            {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        ::new (static_cast<void*>(cell->storage)) T(std::move(item));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    auto try_push_bulk(std::span<T> items) -> std::size_t
+    {
+        std::size_t pushed = 0;
+        while (pushed < items.size() && try_push(std::move(items[pushed])))
+            ++pushed;
+        return pushed;
+    }
+
+    auto try_pop(T& item) -> bool
+    {
+        cell_t* cell;
+        auto pos = _dequeue_pos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &_cells[pos & mask];
+            const auto sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = _dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        auto* stored = std::launder(reinterpret_cast<T*>(cell->storage));
+        item = std::move(*stored);
+        stored->~T();
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    auto empty() const -> bool
+    {
+        return _enqueue_pos.load(std::memory_order_acquire) == _dequeue_pos.load(std::memory_order_acquire);
+    }
+
+    void clear()
+    {
+        T item;
+        while (try_pop(item)) {}
+    }
+
+private:
+    static constexpr std::size_t mask = Capacity - 1;
+
+    std::unique_ptr<cell_t[]> _cells;
+    alignas(cache_line_size) std::atomic<std::size_t> _enqueue_pos{0};
+    alignas(cache_line_size) std::atomic<std::size_t> _dequeue_pos{0};
+};
+
+struct work_stealing_stats
+{
+    std::size_t local_hits = 0;
+    std::size_t steals = 0;
+};
+
+// One deque per hardware thread by default. Dispatcher threads push and pop their own deque,
+// other producers spread events round-robin and idle threads steal from the back of busy ones.
+// Threads are bound to each queue they serve (e.g. priority lanes): for any other queue they are plain producers.
+template <typename T>
+class work_stealing_queue
+{
+    struct alignas(cache_line_size) worker_queue_t
+    {
+        circular_buffer<T> queue;
+        std::mutex mutex;
+        std::atomic<std::size_t> local_hits{0};
+        std::atomic<std::size_t> steals{0};
+    };
+
+public:
+    // The deques are created once and never replaced: producers may push while the dispatcher starts.
+    // Workers above their count share deques.
+    explicit work_stealing_queue(std::size_t workers = std::max(std::thread::hardware_concurrency(), 1u))
+    {
+        _queues.reserve(std::max<std::size_t>(workers, 1));
+        for (std::size_t i = 0; i < std::max<std::size_t>(workers, 1); ++i)
+            _queues.emplace_back(std::make_unique<worker_queue_t>());
+    }
+
+    // Called on the dispatcher thread, once pinned: its deque storage is first touched on the thread NUMA node.
+    void bind_worker(std::size_t worker)
+    {
+        std::erase_if(_bindings, [this](auto&& binding){ return binding.queue == this; });
+        _bindings.push_back({this, worker % _queues.size()});
+
+        auto& local = *_queues[worker % _queues.size()];
+        std::scoped_lock lock(local.mutex);
+        local.queue.reserve(local_reserve);
+    }
+
+    auto try_push(T&& item) -> bool
+    {
+        auto& q = push_queue();
+        std::scoped_lock lock(q.mutex);
+        q.queue.push_back(std::move(item));
+        return true;
+    }
+
+    // The whole batch lands on one deque: idle threads will steal their share of it.
+    auto try_push_bulk(std::span<T> items) -> std::size_t
+    {
+        auto& q = push_queue();
+        std::scoped_lock lock(q.mutex);
+        for (auto&& item : items)
+            q.queue.push_back(std::move(item));
+        return items.size();
+    }
+
+    auto try_pop(T& item) -> bool
+    {
+        const auto worker = worker_index();
+        if (worker >= _queues.size())
+        {
+            for (auto&& q : _queues)
+            {
+                if (pop_front(*q, item))
+                    return true;
+            }
+            return false;
+        }
+
+        auto& local = *_queues[worker];
+        if (pop_front(local, item))
+        {
+            local.local_hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        for (std::size_t i = 1; i < _queues.size(); ++i)
+        {
+            auto& victim = *_queues[(worker + i) % _queues.size()];
+            std::scoped_lock lock(victim.mutex);
+            if (victim.queue.empty())
+                continue;
+
+            item = std::move(victim.queue.back());
+            victim.queue.pop_back();
+            local.steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+    auto empty() const -> bool
+    {
+        return std::all_of(_queues.begin(), _queues.end(), [](auto&& q)
+        {
+            std::scoped_lock lock(q->mutex);
+            return q->queue.empty();
+        });
+    }
+
+    void clear()
+    {
+        for (auto&& q : _queues)
+        {
+            std::scoped_lock lock(q->mutex);
+            q->queue.clear();
+        }
+    }
+
+    auto stats() const -> work_stealing_stats
+    {
+        work_stealing_stats stats;
+        for (auto&& q : _queues)
+        {
+            stats.local_hits += q->local_hits.load(std::memory_order_relaxed);
+            stats.steals += q->steals.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+private:
+    auto push_queue() -> worker_queue_t&
+    {
+        const auto worker = worker_index();
+        return *_queues[worker < _queues.size() ? worker : _next_queue.fetch_add(1, std::memory_order_relaxed) % _queues.size()];
+    }
+
+    // Bound threads are dispatcher threads: they are joined before their queues are destroyed, so a queue address
+    // found here is never a reused one.
+    auto worker_index() const -> std::size_t
+    {
+        for (auto&& binding : _bindings)
+        {
+            if (binding.queue == this)
+                return binding.worker;
+        }
+        return std::numeric_limits<std::size_t>::max();
+    }
+
+    static auto pop_front(worker_queue_t& q, T& item) -> bool
+    {
+        std::scoped_lock lock(q.mutex);
+        if (q.queue.empty())
+            return false;
+
+        item = std::move(q.queue.front());
+        q.queue.pop_front();
+        return true;
+    }
+
+    static constexpr std::size_t local_reserve = 256;
+
+    std::vector<std::unique_ptr<worker_queue_t>> _queues;
+    alignas(cache_line_size) std::atomic<std::size_t> _next_queue{0};
+
+    struct binding_t
+    {
+        const work_stealing_queue* queue;
+        std::size_t worker;
+    };
+
+    static inline thread_local std::vector<binding_t> _bindings;
+};
+
+}
+
+namespace evds::queue_policy
+{
+struct mutex
+{
+    template <typename T>
+    using queue_t = details::mutex_queue<T>;
+};
+
+template <std::size_t Capacity = 4096>
+struct lock_free
+{
+    template <typename T>
+    using queue_t = details::ring_queue<T, Capacity>;
+};
+
+struct work_stealing
+{
+    template <typename T>
+    using queue_t = details::work_stealing_queue<T>;
+};
+
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <evds/thread_placement.hpp>
+
+namespace evds
+{
+// Runs posted work items on its own threads. Dispatchers started on an executor post their work to it.
+template <typename ExecutorT>
+concept executor = requires(ExecutorT& executor, std::function<void()> work)
+{
+    executor.post(std::move(work));
+};
+
+// Executors that can also run work at a deadline: dispatcher timers fire on time even when no event is queued.
+template <typename ExecutorT>
+concept timed_executor = executor<ExecutorT> && requires(ExecutorT& executor, std::chrono::steady_clock::time_point at, std::function<void()> work)
+{
+    executor.post_at(at, std::move(work));
+};
+
+// Fixed set of threads sharing one work queue, meant to be shared by several dispatchers.
+// Work posted before destruction still runs, delayed work not yet due is dropped.
+// Dispatchers started on the pool must be stopped before it is destroyed.
+class thread_pool
+{
+    using clock_t = std::chrono::steady_clock;
+
+    struct delayed_work_t
+    {
+        clock_t::time_point at;
+        std::function<void()> work;
+    };
+
+public:
+    explicit thread_pool(unsigned int threads = std::max(std::thread::hardware_concurrency(), 1u), const std::string& thread_name = "evds-pool")
+    {
+        _threads.reserve(std::max(threads, 1u));
+        for (auto i = 0u; i < std::max(threads, 1u); ++i)
+        {
+            _threads.emplace_back([this, name = thread_name.empty() ? std::string{} : thread_name + "-" + std::to_string(i)]
+            {
+                if (!name.empty())
+                    details::name_this_thread(name);
+                run();
+            });
+        }
+    }
+
+    ~thread_pool()
+    {
+        {
+            std::scoped_lock lock(_mutex);
+            _is_stopping = true;
+        }
+        _cv.notify_all();
+
+        for (auto&& thread : _threads)
+            thread.join();
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool(thread_pool&&) noexcept = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    thread_pool& operator=(thread_pool&&) = delete;
+
+    void post(std::function<void()> work)
+    {
+        {
+            std::scoped_lock lock(_mutex);
+            _work.push_back(std::move(work));
+        }
+        _cv.notify_one();
+    }
+
+    void post_at(clock_t::time_point at, std::function<void()> work)
+    {
+        {
+            std::scoped_lock lock(_mutex);
+            _delayed_work.push_back({at, std::move(work)});
+            std::ranges::push_heap(_delayed_work, std::greater{}, &delayed_work_t::at);
+        }
+        _cv.notify_one();
+    }
+
+    auto size() const -> unsigned int
+    {
+        return static_cast<unsigned int>(_threads.size());
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock lock(_mutex);
+        while (true)
+        {
+            const auto now = clock_t::now();
+            while (!_delayed_work.empty() && _delayed_work.front().at <= now)
+            {
+                std::ranges::pop_heap(_delayed_work, std::greater{}, &delayed_work_t::at);
+                _work.push_back(std::move(_delayed_work.back().work));
+                _delayed_work.pop_back();
+            }
+
+            if (!_work.empty())
+            {
+                auto work = std::move(_work.front());
+                _work.pop_front();
+                lock.unlock();
+                work();
+                lock.lock();
+                continue;
+            }
+
+            if (_is_stopping)
+                return;
+
+            if (_delayed_work.empty())
+                _cv.wait(lock);
+            else
+                _cv.wait_until(lock, clock_t::time_point{_delayed_work.front().at}); // the heap may grow meanwhile
+        }
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<std::function<void()>> _work;
+    std::vector<delayed_work_t> _delayed_work; // min heap on at
+    bool _is_stopping = false;
+    std::vector<std::thread> _threads;
+};
+
+}
+
+namespace evds::details
+{
+// Non owning, type erased reference to an executor.
+class any_executor
+{
+public:
+    any_executor() noexcept = default;
+
+    template <executor ExecutorT>
+    explicit any_executor(ExecutorT& executor) noexcept
+        : _executor{&executor}
+        , _post{[](void* e, std::function<void()> work){ static_cast<ExecutorT*>(e)->post(std::move(work)); }}
+    {
+        if constexpr (timed_executor<ExecutorT>)
+        {
+            _post_at = [](void* e, std::chrono::steady_clock::time_point at, std::function<void()> work)
+            {
+                static_cast<ExecutorT*>(e)->post_at(at, std::move(work));
+            };
+        }
+    }
+
+    auto is_timed() const noexcept -> bool
+    {
+        return _post_at != nullptr;
+    }
+
+    void post(std::function<void()> work) const
+    {
+        _post(_executor, std::move(work));
+    }
+
+    void post_at(std::chrono::steady_clock::time_point at, std::function<void()> work) const
+    {
+        _post_at(_executor, at, std::move(work));
+    }
+
+private:
+    void* _executor = nullptr;
+    void (*_post)(void*, std::function<void()>) = nullptr;
+    void (*_post_at)(void*, std::chrono::steady_clock::time_point, std::function<void()>) = nullptr;
+};
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <type_traits>
 
 namespace evds::details
 {
@@ -10,6 +11,7 @@ struct function_wrapper
     using return_t = RetType;
     using function_t = RetType(std::decay_t<Args>...);
     using wrapper_t = std::function<function_t>;
+    static constexpr bool takes_values = (!std::is_reference_v<Args> && ...);
 };
 
 template <typename T>
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <functional>
+#include <tuple>
+#include <utility>
+
+namespace evds::details
+{
+// Immutable event arguments, built once per emit and handed to every handler as const references.
+template <typename... Args>
+class payload_t
+{
+public:
+    template <typename... CtorArgs>
+    explicit payload_t(std::in_place_t, CtorArgs&&... ctor_args) : _args{std::forward<CtorArgs>(ctor_args)...} {}
+
+    template <typename F>
+    void apply(F&& f) const
+    {
+        std::apply(std::forward<F>(f), _args);
+    }
+
+private:
+    std::tuple<Args...> _args;
+};
+
+// Single argument payloads can be built in place from any of the argument constructors.
+template <typename T>
+class payload_t<T>
+{
+public:
+    template <typename... CtorArgs>
+    explicit payload_t(std::in_place_t, CtorArgs&&... ctor_args) : _value(std::forward<CtorArgs>(ctor_args)...) {}
+
+    template <typename F>
+    void apply(F&& f) const
+    {
+        std::invoke(std::forward<F>(f), _value);
+    }
+
+private:
+    T _value;
+};
+
+}
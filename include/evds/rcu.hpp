@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+#include <evds/event_queue.hpp>
+
+namespace evds::details
+{
+// Read-copy-update reclamation for data published through atomic pointers.
+// Readers only bump a counter on a cache line shared with few other threads, never a lock or a reference count.
+// Writers publish a new pointer, then synchronize() before deleting the old one: it returns once every
+// reader that could still see the old pointer has left its read section.
+class rcu_domain
+{
+    static constexpr std::size_t stripes_count = 16;
+
+    struct alignas(cache_line_size) stripe_t
+    {
+        std::array<std::atomic<std::size_t>, 2> readers{};
+    };
+
+public:
+    class read_guard
+    {
+    public:
+        explicit read_guard(rcu_domain& domain) noexcept
+            : _readers{domain._stripes[this_thread_hash() % stripes_count].readers[domain._epoch.load(std::memory_order_relaxed) & 1]}
+        {
+            _readers.fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        ~read_guard()
+        {
+            _readers.fetch_sub(1, std::memory_order_release);
+        }
+
+        read_guard(const read_guard&) = delete;
+        read_guard(read_guard&&) noexcept = delete;
+        read_guard& operator=(const read_guard&) = delete;
+        read_guard& operator=(read_guard&&) = delete;
+
+    private:
+        std::atomic<std::size_t>& _readers;
+    };
+
+    // Pointers must be loaded with seq_cst inside the read section and stored with seq_cst before synchronize().
+    auto read_lock() noexcept -> read_guard
+    {
+        return read_guard{*this};
+    }
+
+    // Flips the epoch twice: a reader that picked its counter right before a flip is drained by the next one.
+    void synchronize()
+    {
+        std::scoped_lock lock(_writer_mutex);
+        for (int flip = 0; flip < 2; ++flip)
+        {
+            const auto parity = _epoch.fetch_add(1, std::memory_order_seq_cst) & 1;
+            for (auto&& stripe : _stripes)
+            {
+                while (stripe.readers[parity].load(std::memory_order_seq_cst) != 0)
+                    std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    std::array<stripe_t, stripes_count> _stripes;
+    alignas(cache_line_size) std::atomic<std::size_t> _epoch{0};
+    std::mutex _writer_mutex;
+};
+
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include <evds/event_key.hpp>
+#include <evds/event_options.hpp>
+#include <evds/event_queue.hpp>
+
+namespace evds
+{
+// Bucket 0 counts durations of 0 ns, bucket i counts durations in [2^(i-1), 2^i) ns. The last one also counts longer ones.
+inline constexpr std::size_t histogram_buckets_count = 40;
+
+struct latency_histogram
+{
+    std::array<std::uint64_t, histogram_buckets_count> buckets{};
+
+    auto count() const -> std::uint64_t
+    {
+        std::uint64_t count = 0;
+        for (const auto bucket : buckets)
+            count += bucket;
+        return count;
+    }
+
+    // Upper bound of the bucket holding the p-th percentile, p in [0, 1].
+    auto percentile(double p) const -> std::chrono::nanoseconds
+    {
+        const auto total = count();
+        if (total == 0)
+            return std::chrono::nanoseconds{0};
+
+        const auto rank = std::max<std::uint64_t>(static_cast<std::uint64_t>(std::clamp(p, 0.0, 1.0) * static_cast<double>(total) + 0.5), 1);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets.size(); ++i)
+        {
+            seen += buckets[i];
+            if (seen >= rank)
+                return std::chrono::nanoseconds{i == 0 ? 0 : std::int64_t{1} << i};
+        }
+        return std::chrono::nanoseconds{std::int64_t{1} << (buckets.size() - 1)};
+    }
+
+    auto operator+=(const latency_histogram& other) -> latency_histogram&
+    {
+        for (std::size_t i = 0; i < buckets.size(); ++i)
+            buckets[i] += other.buckets[i];
+        return *this;
+    }
+};
+
+struct event_stats
+{
+    std::uint64_t emitted = 0;          // emits that reached handlers, queued or inline
+    std::uint64_t dispatched = 0;       // handler calls run by dispatcher threads
+    std::uint64_t dropped = 0;          // emits dropped or rejected by the overflow policy
+    std::uint64_t no_handlers = 0;      // emits that found no handler
+    std::uint64_t coalesced = 0;        // emits whose payload was replaced by a newer one, conflated events only
+    latency_histogram queueing_latency; // from emit to the task start, per task
+    latency_histogram handler_time;     // per handler call
+
+    auto operator+=(const event_stats& other) -> event_stats&
+    {
+        emitted += other.emitted;
+        dispatched += other.dispatched;
+        dropped += other.dropped;
+        no_handlers += other.no_handlers;
+        coalesced += other.coalesced;
+        queueing_latency += other.queueing_latency;
+        handler_time += other.handler_time;
+        return *this;
+    }
+};
+
+struct dispatcher_stats
+{
+    event_stats total;                                                // every event, unregistered ones included
+    std::array<std::size_t, event_priorities_count> queue_depth{};    // per lane
+    std::unordered_map<event_id_t, event_stats> events;               // per registered event
+};
+
+}
+
+namespace evds::details
+{
+// Counters of a single event. Threads write to their own stripe (picked by thread id hash),
+// stripes are only summed up on read: hot counters are not shared between dispatcher threads.
+class event_counters
+{
+    static constexpr std::size_t stripes_count = 8;
+
+    using buckets_t = std::array<std::atomic<std::uint64_t>, histogram_buckets_count>;
+
+    struct alignas(cache_line_size) stripe_t
+    {
+        std::atomic<std::uint64_t> emitted{0};
+        std::atomic<std::uint64_t> dispatched{0};
+        std::atomic<std::uint64_t> dropped{0};
+        std::atomic<std::uint64_t> no_handlers{0};
+        std::atomic<std::uint64_t> coalesced{0};
+        buckets_t queueing_latency{};
+        buckets_t handler_time{};
+    };
+
+public:
+    void count_emit(emit_status status, std::uint64_t count = 1) noexcept
+    {
+        auto& stripe = this_stripe();
+        switch (status)
+        {
+        case emit_status::queued: stripe.emitted.fetch_add(count, std::memory_order_relaxed); break;
+        case emit_status::no_handlers: stripe.no_handlers.fetch_add(count, std::memory_order_relaxed); break;
+        case emit_status::dropped:
+        case emit_status::rejected: stripe.dropped.fetch_add(count, std::memory_order_relaxed); break;
+        }
+    }
+
+    void count_coalesced() noexcept
+    {
+        this_stripe().coalesced.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void record_queueing(std::chrono::steady_clock::duration latency) noexcept
+    {
+        this_stripe().queueing_latency[bucket_of(latency)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void record_handler(std::chrono::steady_clock::duration time) noexcept
+    {
+        auto& stripe = this_stripe();
+        stripe.dispatched.fetch_add(1, std::memory_order_relaxed);
+        stripe.handler_time[bucket_of(time)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    auto load() const -> event_stats
+    {
+        event_stats stats;
+        for (auto&& stripe : _stripes)
+        {
+            stats.emitted += stripe.emitted.load(std::memory_order_relaxed);
+            stats.dispatched += stripe.dispatched.load(std::memory_order_relaxed);
+            stats.dropped += stripe.dropped.load(std::memory_order_relaxed);
+            stats.no_handlers += stripe.no_handlers.load(std::memory_order_relaxed);
+            stats.coalesced += stripe.coalesced.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < histogram_buckets_count; ++i)
+            {
+                stats.queueing_latency.buckets[i] += stripe.queueing_latency[i].load(std::memory_order_relaxed);
+                stats.handler_time.buckets[i] += stripe.handler_time[i].load(std::memory_order_relaxed);
+            }
+        }
+        return stats;
+    }
+
+private:
+    static auto bucket_of(std::chrono::steady_clock::duration duration) noexcept -> std::size_t
+    {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        return std::min<std::size_t>(std::bit_width(static_cast<std::uint64_t>(std::max<std::int64_t>(ns, 0))), histogram_buckets_count - 1);
+    }
+
+    auto this_stripe() noexcept -> stripe_t&
+    {
+        return _stripes[this_thread_hash() % stripes_count];
+    }
+
+    std::array<stripe_t, stripes_count> _stripes;
+};
+
+}
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <evds/event_queue.hpp>
+
+namespace evds::details
+{
+// Fixed size blocks carved out of 64 KiB chunks, recycled through free lists.
+// Threads are spread over a few stripes to keep lock contention low, and every chunk
+// remembers its stripe so blocks always go back to the free list they came from.
+class slab_pool
+{
+    static constexpr std::size_t chunk_size = 64 * 1024;
+    static constexpr std::size_t stripes_count = 8;
+    static constexpr std::array<std::size_t, 5> block_sizes = {64, 128, 256, 512, 1024};
+
+    struct chunk_header_t
+    {
+        std::size_t stripe;
+        std::size_t size_class;
+    };
+
+    struct free_block_t
+    {
+        free_block_t* next;
+    };
+
+    struct size_class_t
+    {
+        free_block_t* free_list = nullptr;
+        std::byte* next = nullptr;
+        std::byte* end = nullptr;
+    };
+
+    struct alignas(cache_line_size) stripe_t
+    {
+        std::mutex mutex;
+        std::array<size_class_t, block_sizes.size()> size_classes;
+        std::vector<void*> chunks;
+    };
+
+public:
+    static constexpr std::size_t max_block_size = block_sizes.back();
+
+    slab_pool() = default;
+
+    ~slab_pool()
+    {
+        for (auto&& stripe : _stripes)
+        {
+            for (auto* chunk : stripe.chunks)
+                ::operator delete(chunk, std::align_val_t{chunk_size});
+        }
+    }
+
+    slab_pool(const slab_pool&) = delete;
+    slab_pool(slab_pool&&) noexcept = delete;
+    slab_pool& operator=(const slab_pool&) = delete;
+    slab_pool& operator=(slab_pool&&) = delete;
+
+    auto allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) -> void*
+    {
+        if (size > max_block_size || alignment > cache_line_size)
+            return ::operator new(size, std::align_val_t{alignment});
+
+        const auto size_class = get_size_class(size);
+        const auto stripe_index = this_thread_hash() % stripes_count;
+        auto& stripe = _stripes[stripe_index];
+
+        std::scoped_lock lock(stripe.mutex);
+        auto& blocks = stripe.size_classes[size_class];
+        if (blocks.free_list)
+        {
+            auto* block = blocks.free_list;
+            blocks.free_list = block->next;
+            return block;
+        }
+
+        if (blocks.next == blocks.end)
+        {
+            auto* chunk = static_cast<std::byte*>(::operator new(chunk_size, std::align_val_t{chunk_size}));
+            stripe.chunks.push_back(chunk);
+            ::new (chunk) chunk_header_t{stripe_index, size_class};
+            blocks.next = chunk + cache_line_size;
+            blocks.end = chunk + chunk_size - (chunk_size - cache_line_size) % block_sizes[size_class];
+        }
+
+        auto* block = blocks.next;
+        blocks.next += block_sizes[size_class];
+        return block;
+    }
+
+    void deallocate(void* ptr, std::size_t size, std::size_t alignment = alignof(std::max_align_t)) noexcept
+    {
+        if (size > max_block_size || alignment > cache_line_size)
+        {
+            ::operator delete(ptr, std::align_val_t{alignment});
+            return;
+        }
+
+        const auto* header = reinterpret_cast<const chunk_header_t*>(reinterpret_cast<std::uintptr_t>(ptr) & ~(chunk_size - 1));
+        auto& stripe = _stripes[header->stripe];
+
+        std::scoped_lock lock(stripe.mutex);
+        auto& blocks = stripe.size_classes[header->size_class];
+        blocks.free_list = ::new (ptr) free_block_t{blocks.free_list};
+    }
+
+private:
+    static auto get_size_class(std::size_t size) -> std::size_t
+    {
+        return static_cast<std::size_t>(std::lower_bound(block_sizes.begin(), block_sizes.end(), size) - block_sizes.begin());
+    }
+
+    std::array<stripe_t, stripes_count> _stripes;
+};
+
+template <typename T>
+class pool_allocator
+{
+public:
+    using value_type = T;
+
+    explicit pool_allocator(slab_pool& pool) noexcept : _pool{&pool} {}
+
+    template <typename U>
+    pool_allocator(const pool_allocator<U>& other) noexcept : _pool{other.pool()} {}
+
+    auto allocate(std::size_t n) -> T*
+    {
+        return static_cast<T*>(_pool->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept
+    {
+        _pool->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    auto pool() const noexcept -> slab_pool*
+    {
+        return _pool;
+    }
+
+    template <typename U>
+    auto operator==(const pool_allocator<U>& other) const noexcept -> bool
+    {
+        return _pool == other.pool();
+    }
+
+private:
+    slab_pool* _pool;
+};
+
+// Move-only void() callable. Closures up to Size bytes live inside the task itself,
+// bigger ones are allocated from the slab pool given at construction.
+// The owner may tag a task with a byte of its own: it sits in the padding before the storage and costs no space.
+template <std::size_t Size>
+class inline_task
+{
+    static_assert(Size >= 2 * sizeof(void*), "inline_task buffer must at least fit two pointers");
+
+    struct vtable_t
+    {
+        void (*invoke)(std::byte*);
+        void (*move)(std::byte* dst, std::byte* src) noexcept;
+        void (*destroy)(std::byte*) noexcept;
+    };
+
+    template <typename F>
+    static constexpr bool is_stored_inline = sizeof(F) <= Size && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+
+    template <typename F>
+    struct pooled_t
+    {
+        F* f;
+        slab_pool* pool;
+    };
+
+    template <typename F>
+    static constexpr vtable_t inline_vtable = {
+        [](std::byte* storage) { std::invoke(*std::launder(reinterpret_cast<F*>(storage))); },
+        [](std::byte* dst, std::byte* src) noexcept
+        {
+            auto* f = std::launder(reinterpret_cast<F*>(src));
+            ::new (dst) F(std::move(*f));
+            f->~F();
+        },
+        [](std::byte* storage) noexcept { std::launder(reinterpret_cast<F*>(storage))->~F(); }
+    };
+
+    template <typename F>
+    static constexpr vtable_t pooled_vtable = {
+        [](std::byte* storage) { std::invoke(*std::launder(reinterpret_cast<pooled_t<F>*>(storage))->f); },
+        [](std::byte* dst, std::byte* src) noexcept { ::new (dst) pooled_t<F>(*std::launder(reinterpret_cast<pooled_t<F>*>(src))); },
+        [](std::byte* storage) noexcept
+        {
+            const auto pooled = *std::launder(reinterpret_cast<pooled_t<F>*>(storage));
+            pooled.f->~F();
+            pooled.pool->deallocate(pooled.f, sizeof(F), alignof(F));
+        }
+    };
+
+public:
+    inline_task() noexcept = default;
+
+    template <typename FunctionT, typename F = std::decay_t<FunctionT>>
+    inline_task(FunctionT&& f, slab_pool& pool, std::uint8_t tag = 0) : _tag{tag}
+    {
+        if constexpr (is_stored_inline<F>)
+        {
+            ::new (_storage) F(std::forward<FunctionT>(f));
+            _vtable = &inline_vtable<F>;
+        }
+        else
+        {
+            auto* ptr = static_cast<F*>(pool.allocate(sizeof(F), alignof(F)));
+            try
+            {
+                ::new (ptr) F(std::forward<FunctionT>(f));
+            }
+            catch (...)
+            {
+                pool.deallocate(ptr, sizeof(F), alignof(F));
+                throw;
+            }
+            ::new (_storage) pooled_t<F>{ptr, &pool};
+            _vtable = &pooled_vtable<F>;
+        }
+    }
+
+    ~inline_task()
+    {
+        reset();
+    }
+
+    inline_task(const inline_task&) = delete;
+    inline_task& operator=(const inline_task&) = delete;
+
+    inline_task(inline_task&& other) noexcept
+    {
+        move_from(other);
+    }
+
+    inline_task& operator=(inline_task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    void operator()()
+    {
+        _vtable->invoke(_storage);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return _vtable != nullptr;
+    }
+
+    auto tag() const noexcept -> std::uint8_t
+    {
+        return _tag;
+    }
+
+    void reset() noexcept
+    {
+        if (_vtable)
+        {
+            _vtable->destroy(_storage);
+            _vtable = nullptr;
+        }
+    }
+
+    template <typename F>
+    static constexpr auto fits_inline() -> bool
+    {
+        return is_stored_inline<F>;
+    }
+
+private:
+    void move_from(inline_task& other) noexcept
+    {
+        if (other._vtable)
+        {
+            other._vtable->move(_storage, other._storage);
+            _vtable = std::exchange(other._vtable, nullptr);
+        }
+        _tag = other._tag;
+    }
+
+    const vtable_t* _vtable = nullptr;
+    std::uint8_t _tag = 0;
+    alignas(std::max_align_t) std::byte _storage[Size];
+};
+
+}
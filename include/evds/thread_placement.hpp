@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace evds::details
+{
+// Pins the calling thread. Returns false, leaving placement to the OS, when the platform does not support it
+// or a CPU is out of range or offline.
+inline auto pin_this_thread(const std::vector<unsigned int>& cpus) -> bool
+{
+#if defined(__linux__)
+    if (cpus.empty())
+        return false;
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (const auto cpu : cpus)
+    {
+        if (cpu >= CPU_SETSIZE)
+            return false;
+        CPU_SET(cpu, &cpu_set);
+    }
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+// Names the calling thread for debuggers and profilers. Names are truncated to the platform limit.
+inline auto name_this_thread(const std::string& name) -> bool
+{
+#if defined(__linux__)
+    constexpr std::size_t max_name_length = 15;
+    return pthread_setname_np(pthread_self(), name.substr(0, max_name_length).c_str()) == 0;
+#elif defined(__APPLE__)
+    constexpr std::size_t max_name_length = 63;
+    return pthread_setname_np(name.substr(0, max_name_length).c_str()) == 0;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+}
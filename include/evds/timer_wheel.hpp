@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace evds::details
+{
+// Hierarchical timing wheel over abstract ticks: levels of 64 slots, a slot of level l spans 64^l ticks.
+// Timers are nodes of a slab linked into slot lists and addressed by (generation, index) ids, so adding and
+// cancelling are O(1). Advancing jumps straight to the next occupied slot: timers move down one level per cascade.
+// Not thread safe, except for the callbacks collected by advance(): they may run on another thread, unlocked.
+class timer_wheel
+{
+    static constexpr std::size_t slot_bits = 6;
+    static constexpr std::size_t slots_count = std::size_t{1} << slot_bits;
+    static constexpr std::size_t levels_count = 5; // 2^30 ticks: later deadlines are filed again when the top slot is reached
+    static constexpr std::uint32_t nil = std::numeric_limits<std::uint32_t>::max();
+
+public:
+    // Callbacks collected as due may still be queued when their timer is cancelled: the call is then skipped.
+    class timer_callback
+    {
+    public:
+        explicit timer_callback(std::function<void()> work) : _work{std::move(work)} {}
+
+        void operator()() const
+        {
+            if (!_is_cancelled.load(std::memory_order_acquire))
+                _work();
+        }
+
+    private:
+        friend class timer_wheel;
+
+        std::function<void()> _work;
+        mutable std::atomic_bool _is_cancelled{false};
+    };
+
+    using callback_t = std::shared_ptr<const timer_callback>;
+
+    static constexpr std::uint64_t never = std::numeric_limits<std::uint64_t>::max();
+
+    // Deadlines not after the last advanced tick are pushed to the next one. A period of 0 makes a one-shot timer.
+    auto add(std::uint64_t deadline, std::uint64_t period, std::function<void()> callback) -> std::uint64_t
+    {
+        std::uint32_t index = _free;
+        if (index != nil)
+        {
+            _free = _nodes[index].next;
+        }
+        else
+        {
+            index = static_cast<std::uint32_t>(_nodes.size());
+            _nodes.emplace_back();
+        }
+
+        auto& node = _nodes[index];
+        node.deadline = std::max(deadline, _now + 1);
+        node.period = period;
+        node.callback = std::make_shared<const timer_callback>(std::move(callback));
+        ++node.generation;
+        link(index);
+        ++_size;
+        return (std::uint64_t{node.generation} << 32) | index;
+    }
+
+    // False when the timer is unknown: already fired (one-shot), cancelled or cleared.
+    // A due callback of the timer that advance() collected and that has not started yet is skipped.
+    auto cancel(std::uint64_t id) -> bool
+    {
+        const auto index = static_cast<std::uint32_t>(id);
+        if (index >= _nodes.size() || _nodes[index].generation != static_cast<std::uint32_t>(id >> 32) || !_nodes[index].callback)
+            return false;
+
+        _nodes[index].callback->_is_cancelled.store(true, std::memory_order_release);
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    // Moves the wheel to tick now. Callbacks of the timers due meanwhile are appended to due, in deadline order.
+    // Periodic timers fire once and are filed again on their first period boundary after now: missed periods are skipped.
+    void advance(std::uint64_t now, std::vector<callback_t>& due)
+    {
+        for (auto tick = next_tick(); tick <= now; tick = next_tick())
+        {
+            _now = tick;
+            // Higher levels first: timers cascading down may land in a lower slot reached on this very tick.
+            for (auto level = levels_count - 1; level > 0; --level)
+            {
+                const auto shift = slot_bits * level;
+                if ((tick & ((std::uint64_t{1} << shift) - 1)) == 0)
+                    cascade(level, (tick >> shift) & (slots_count - 1), now, due);
+            }
+            cascade(0, tick & (slots_count - 1), now, due);
+        }
+        _now = std::max(_now, now);
+    }
+
+    // First tick at which advance() has something to do: a timer deadline, or a lower bound of it when a cascade is due first.
+    auto next_tick() const -> std::uint64_t
+    {
+        auto tick = never;
+        for (std::size_t level = 0; level < levels_count; ++level)
+        {
+            if (_occupied[level] == 0)
+                continue;
+
+            const auto shift = slot_bits * level;
+            const auto base = _now >> shift;
+            const auto offset = static_cast<std::uint64_t>(std::countr_zero(std::rotr(_occupied[level], static_cast<int>((base + 1) & (slots_count - 1))))) + 1;
+            tick = std::min(tick, (base + offset) << shift);
+        }
+        return tick;
+    }
+
+    auto size() const -> std::size_t
+    {
+        return _size;
+    }
+
+    // Ids of cleared timers stay invalid: generations are kept.
+    void clear()
+    {
+        for (std::uint32_t index = 0; index < _nodes.size(); ++index)
+        {
+            if (_nodes[index].callback)
+            {
+                _nodes[index].callback->_is_cancelled.store(true, std::memory_order_release);
+                release(index);
+            }
+        }
+        _heads.fill(nil);
+        _occupied.fill(0);
+    }
+
+private:
+    struct node_t
+    {
+        std::uint64_t deadline = 0;
+        std::uint64_t period = 0;
+        callback_t callback; // null on free nodes
+        std::uint32_t prev = nil;
+        std::uint32_t next = nil;
+        std::uint32_t generation = 0;
+        std::uint32_t slot = 0; // level * slots_count + slot index
+    };
+
+    void link(std::uint32_t index)
+    {
+        auto& node = _nodes[index];
+        const auto max_delta = (std::uint64_t{1} << (slot_bits * levels_count)) - 1;
+        const auto deadline = node.deadline - _now > max_delta ? _now + max_delta : node.deadline;
+
+        std::size_t level = 0;
+        while (level < levels_count - 1 && deadline - _now >= (std::uint64_t{1} << (slot_bits * (level + 1))))
+            ++level;
+
+        node.slot = static_cast<std::uint32_t>(level * slots_count + ((deadline >> (slot_bits * level)) & (slots_count - 1)));
+        node.prev = nil;
+        node.next = _heads[node.slot];
+        if (node.next != nil)
+            _nodes[node.next].prev = index;
+        _heads[node.slot] = index;
+        _occupied[level] |= std::uint64_t{1} << (node.slot & (slots_count - 1));
+    }
+
+    void unlink(std::uint32_t index)
+    {
+        const auto& node = _nodes[index];
+        if (node.prev != nil)
+            _nodes[node.prev].next = node.next;
+        else
+            _heads[node.slot] = node.next;
+
+        if (node.next != nil)
+            _nodes[node.next].prev = node.prev;
+
+        if (_heads[node.slot] == nil)
+            _occupied[node.slot / slots_count] &= ~(std::uint64_t{1} << (node.slot & (slots_count - 1)));
+    }
+
+    void release(std::uint32_t index)
+    {
+        auto& node = _nodes[index];
+        node.callback.reset();
+        node.next = _free;
+        _free = index;
+        --_size;
+    }
+
+    // Empties a slot: due timers fire, the others go down to the level matching their remaining delay.
+    void cascade(std::size_t level, std::size_t slot, std::uint64_t until, std::vector<callback_t>& due)
+    {
+        auto& head = _heads[level * slots_count + slot];
+        auto index = std::exchange(head, nil);
+        _occupied[level] &= ~(std::uint64_t{1} << slot);
+
+        while (index != nil)
+        {
+            auto& node = _nodes[index];
+            const auto next = node.next;
+            if (node.deadline > _now)
+            {
+                link(index);
+            }
+            else if (node.period != 0)
+            {
+                due.push_back(node.callback);
+                node.deadline += node.period * ((until - node.deadline) / node.period + 1);
+                link(index);
+            }
+            else
+            {
+                due.push_back(std::move(node.callback));
+                release(index);
+            }
+            index = next;
+        }
+    }
+
+    std::vector<node_t> _nodes;
+    std::uint32_t _free = nil;
+    std::size_t _size = 0;
+    std::uint64_t _now = 0;
+    std::array<std::uint32_t, levels_count * slots_count> _heads = make_heads();
+    std::array<std::uint64_t, levels_count> _occupied{};
+
+    static constexpr auto make_heads() -> std::array<std::uint32_t, levels_count * slots_count>
+    {
+        std::array<std::uint32_t, levels_count * slots_count> heads{};
+        heads.fill(nil);
+        return heads;
+    }
+};
+
+}
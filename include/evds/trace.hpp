@@ -0,0 +1,262 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <evds/event_key.hpp>
+
+namespace evds::details
+{
+enum class trace_kind : std::uint8_t
+{
+    emit,   // event queued by a producer thread
+    pickup, // task started by a dispatcher thread
+    handler // handler call, with its duration
+};
+
+struct trace_record
+{
+    trace_kind kind;
+    std::int64_t timestamp; // ns since the trace log creation
+    std::int64_t duration;  // ns, handler records only
+    event_id_t event_id;
+    std::uint64_t handler_id;
+    std::uint64_t emit_id;
+};
+
+// Single writer ring of the last capacity records of one thread: the writer never waits and overwrites the oldest records.
+// Readers copy records under a per slot sequence number and skip the ones being overwritten meanwhile.
+class trace_buffer
+{
+    struct slot_t
+    {
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<trace_kind> kind{trace_kind::emit};
+        std::atomic<std::int64_t> timestamp{0};
+        std::atomic<std::int64_t> duration{0};
+        std::atomic<event_id_t> event_id{0};
+        std::atomic<std::uint64_t> handler_id{0};
+        std::atomic<std::uint64_t> emit_id{0};
+    };
+
+public:
+    static constexpr std::size_t capacity = 8192;
+
+    explicit trace_buffer(std::string name) : name{std::move(name)}, _slots{std::make_unique<slot_t[]>(capacity)} {}
+
+    void push(const trace_record& record) noexcept
+    {
+        const auto index = _head.load(std::memory_order_relaxed);
+        auto& slot = _slots[index & (capacity - 1)];
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.kind.store(record.kind, std::memory_order_relaxed);
+        slot.timestamp.store(record.timestamp, std::memory_order_relaxed);
+        slot.duration.store(record.duration, std::memory_order_relaxed);
+        slot.event_id.store(record.event_id, std::memory_order_relaxed);
+        slot.handler_id.store(record.handler_id, std::memory_order_relaxed);
+        slot.emit_id.store(record.emit_id, std::memory_order_relaxed);
+        slot.sequence.store(index + 1, std::memory_order_release);
+        _head.store(index + 1, std::memory_order_release);
+    }
+
+    auto records() const -> std::vector<trace_record>
+    {
+        std::vector<trace_record> records;
+        const auto head = _head.load(std::memory_order_acquire);
+        for (auto index = head - std::min<std::uint64_t>(head, capacity); index < head; ++index)
+        {
+            const auto& slot = _slots[index & (capacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != index + 1)
+                continue;
+
+            const trace_record record{
+                slot.kind.load(std::memory_order_relaxed),
+                slot.timestamp.load(std::memory_order_relaxed),
+                slot.duration.load(std::memory_order_relaxed),
+                slot.event_id.load(std::memory_order_relaxed),
+                slot.handler_id.load(std::memory_order_relaxed),
+                slot.emit_id.load(std::memory_order_relaxed)};
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == index + 1)
+                records.push_back(record);
+        }
+        return records;
+    }
+
+    std::string name;
+
+private:
+    std::unique_ptr<slot_t[]> _slots;
+    std::atomic<std::uint64_t> _head{0};
+};
+
+// One buffer per thread and log, created on the thread first record. Threads keep a pointer to the buffer
+// of the last log they wrote to, so recording only takes the registry lock when a thread switches logs.
+class trace_log
+{
+public:
+    using clock_t = std::chrono::steady_clock;
+
+    trace_log() : _log_id{next_log_id()}, _epoch{clock_t::now()} {}
+
+    trace_log(const trace_log&) = delete;
+    trace_log(trace_log&&) noexcept = delete;
+    trace_log& operator=(const trace_log&) = delete;
+    trace_log& operator=(trace_log&&) = delete;
+
+    // Names the calling thread in the dumped trace.
+    void name_this_thread(std::string name)
+    {
+        auto& buffer = this_thread_buffer();
+        std::scoped_lock lock(_mutex);
+        buffer.name = std::move(name);
+    }
+
+    auto record_emit(event_id_t event_id, clock_t::time_point at) -> std::uint64_t
+    {
+        const auto emit_id = _emit_ids.fetch_add(1, std::memory_order_relaxed) + 1;
+        this_thread_buffer().push({trace_kind::emit, since_epoch(at), 0, event_id, 0, emit_id});
+        return emit_id;
+    }
+
+    void record_pickup(event_id_t event_id, std::uint64_t emit_id, clock_t::time_point at)
+    {
+        this_thread_buffer().push({trace_kind::pickup, since_epoch(at), 0, event_id, 0, emit_id});
+    }
+
+    void record_handler(event_id_t event_id, std::uint64_t emit_id, std::uint64_t handler_id, clock_t::time_point started, clock_t::time_point finished)
+    {
+        this_thread_buffer().push({trace_kind::handler, since_epoch(started), since_epoch(finished) - since_epoch(started), event_id, handler_id, emit_id});
+    }
+
+    // Chrome trace event format, readable by chrome://tracing and ui.perfetto.dev.
+    // Emits and pickups are instant events linked by flow arrows, handler calls are complete events.
+    template <typename EventNameF>
+    void write(std::ostream& out, EventNameF&& event_name) const
+    {
+        std::vector<std::pair<std::string, std::vector<trace_record>>> threads;
+        {
+            std::scoped_lock lock(_mutex);
+            for (auto&& buffer : _buffers)
+                threads.emplace_back(buffer->name, buffer->records());
+        }
+
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        const char* separator = "\n";
+        for (std::size_t tid = 0; tid < threads.size(); ++tid)
+        {
+            const auto& [thread_name, records] = threads[tid];
+            out << separator << R"({"ph":"M","name":"thread_name","pid":1,"tid":)" << tid << R"(,"args":{"name":)" << quoted(thread_name) << "}}";
+            separator = ",\n";
+
+            for (auto&& record : records)
+            {
+                const auto name = quoted(event_name(record.event_id));
+                const auto common = ",\"pid\":1,\"tid\":" + std::to_string(tid) + ",\"ts\":" + microseconds(record.timestamp);
+                switch (record.kind)
+                {
+                case trace_kind::emit:
+                    out << separator << R"({"ph":"i","s":"t","cat":"emit","name":)" << name << common << R"(,"args":{"emit":)" << record.emit_id << "}}";
+                    out << separator << R"({"ph":"s","cat":"flow","name":"dispatch","id":)" << record.emit_id << common << "}";
+                    break;
+                case trace_kind::pickup:
+                    out << separator << R"({"ph":"i","s":"t","cat":"pickup","name":)" << name << common << R"(,"args":{"emit":)" << record.emit_id << "}}";
+                    out << separator << R"({"ph":"f","bp":"e","cat":"flow","name":"dispatch","id":)" << record.emit_id << common << "}";
+                    break;
+                case trace_kind::handler:
+                    out << separator << R"({"ph":"X","cat":"handler","name":)" << name << common << ",\"dur\":" << microseconds(record.duration)
+                        << R"(,"args":{"handler":)" << record.handler_id << R"(,"emit":)" << record.emit_id << "}}";
+                    break;
+                }
+            }
+        }
+        out << "\n]}\n";
+    }
+
+private:
+    struct thread_cache_t
+    {
+        std::uint64_t log_id = 0;
+        trace_buffer* buffer = nullptr;
+    };
+
+    static auto next_log_id() -> std::uint64_t
+    {
+        static std::atomic<std::uint64_t> log_ids{0};
+        return log_ids.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    auto this_thread_buffer() -> trace_buffer&
+    {
+        static thread_local thread_cache_t cache;
+        if (cache.log_id == _log_id)
+            return *cache.buffer;
+
+        std::scoped_lock lock(_mutex);
+        auto& buffer = _thread_buffers[std::this_thread::get_id()];
+        if (!buffer)
+            buffer = _buffers.emplace_back(std::make_unique<trace_buffer>("thread-" + std::to_string(_buffers.size()))).get();
+
+        cache = {_log_id, buffer};
+        return *buffer;
+    }
+
+    auto since_epoch(clock_t::time_point at) const -> std::int64_t
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(at - _epoch).count();
+    }
+
+    static auto microseconds(std::int64_t ns) -> std::string
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(ns) / 1000.0);
+        return buffer;
+    }
+
+    static auto quoted(std::string_view str) -> std::string
+    {
+        std::string quoted = "\"";
+        for (const char c : str)
+        {
+            if (c == '"' || c == '\\')
+            {
+                quoted += '\\';
+                quoted += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+                quoted += escaped;
+            }
+            else
+            {
+                quoted += c;
+            }
+        }
+        return quoted + "\"";
+    }
+
+    const std::uint64_t _log_id;
+    const clock_t::time_point _epoch;
+    std::atomic<std::uint64_t> _emit_ids{0};
+    mutable std::mutex _mutex;
+    std::vector<std::unique_ptr<trace_buffer>> _buffers;
+    std::unordered_map<std::thread::id, trace_buffer*> _thread_buffers;
+};
+
+}
@@ -3,10 +3,16 @@
 #include <future>
 #include <semaphore>
 #include <latch>
+#include <numeric>
+#include <random>
+#include <sstream>
 
 namespace evds::tests
 {
 using evds_test = evds::tests::event_dispatcher_test;
+using evds_lock_free_test = evds::tests::lock_free_event_dispatcher_test;
+using evds_work_stealing_test = evds::tests::work_stealing_event_dispatcher_test;
+using evds_small_task_test = evds::tests::small_task_event_dispatcher_test;
 
 // NOLINTNEXTLINE
 TEST_F(evds_test, start_twice)
@@ -400,4 +406,2160 @@ TEST_F(evds_test, push_after_remove)
     EXPECT_EQ(call_count, 3);
 }
 
-}
\ No newline at end of file
+// NOLINTNEXTLINE
+TEST_F(evds_test, event_key_keeps_argument_order)
+{
+    static_assert(evds::make_event_id<int, float>("EVENT_NAME") != evds::make_event_id<float, int>("EVENT_NAME"));
+    static_assert(evds::make_event_id<int, float>("EVENT_NAME") == evds::event_key<int, float>("EVENT_NAME").id);
+
+    const auto event_name = "EVENT_NAME";
+    e->add_handler<int, float>(event_name, [](int i, float f){});
+    EXPECT_FALSE((e->emit(event_name, 1.f, 1)));
+    EXPECT_TRUE((e->emit(event_name, 1, 1.f)));
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, event_key_collision_is_detected)
+{
+    EXPECT_NE((evds::details::signature<int, float>()), (evds::details::signature<float, int>()));
+    EXPECT_EQ(evds::details::signature<const int&>(), evds::details::signature<int>());
+
+    // A forged key stands for a hash collision: same id, other arguments.
+    evds::event_key<std::string> forged{"EVENT_NAME"};
+    forged.id = evds::make_event_id<int>("EVENT_NAME");
+    e->add_handler<int>("EVENT_NAME", [](int){});
+    EXPECT_DEBUG_DEATH(e->add_handler(forged, [](const std::string&){}), "event id collision");
+    EXPECT_DEBUG_DEATH(e->emit(forged, "payload"), "event id collision");
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_compile_time_name)
+{
+    e->start();
+
+    std::promise<int> promise;
+    std::future<int> future = promise.get_future();
+    e->add_handler<int>("EVENT_NAME", [&promise](int i){ promise.set_value(i); });
+
+    const int expected_value = 123456789;
+    EXPECT_FALSE(e->emit<"EVENT_NAME">(1.f));
+    EXPECT_FALSE(e->emit<"OTHER_EVENT_NAME">(expected_value));
+    EXPECT_TRUE(e->emit<"EVENT_NAME">(expected_value));
+    EXPECT_EQ(expected_value, future.get());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_constexpr_key)
+{
+    e->start();
+    constexpr evds::event_key<std::string, int> key("EVENT_NAME");
+
+    std::promise<std::string> promise;
+    std::future<std::string> future = promise.get_future();
+    e->add_handler<"EVENT_NAME", std::string, int>([&promise](const std::string& s, int i){ promise.set_value(s + std::to_string(i)); });
+
+    EXPECT_TRUE(e->emit(key, "payload", 1));
+    EXPECT_EQ("payload1", future.get());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_same_payload_to_every_handler)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start();
+
+    std::promise<std::string> promise_1;
+    std::future<std::string> future_1 = promise_1.get_future();
+    e->add_handler<std::string>(event_name, [&promise_1](const std::string& s){ promise_1.set_value(s); });
+
+    std::promise<std::string> promise_2;
+    std::future<std::string> future_2 = promise_2.get_future();
+    e->add_handler<std::string>(event_name, [&promise_2](const std::string& s){ promise_2.set_value(s); });
+
+    const std::string expected_value = "some_random_string";
+    EXPECT_TRUE(e->emit(event_name, expected_value));
+    EXPECT_EQ(expected_value, future_1.get());
+    EXPECT_EQ(expected_value, future_2.get());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_handle)
+{
+    e->start();
+    auto handle = e->register_event<int>("EVENT_NAME");
+    EXPECT_FALSE(handle.emit(1)); // no handler yet
+
+    std::atomic<int> payload = 0;
+    std::counting_semaphore<1> sync(0);
+    const auto id = e->add_handler<int>("EVENT_NAME", [&payload, &sync](int i){ payload = i; sync.release(); });
+
+    EXPECT_TRUE(handle.emit(123456789));
+    sync.acquire();
+    EXPECT_EQ(payload, 123456789);
+
+    EXPECT_TRUE(e->remove_handler(id));
+    EXPECT_FALSE(handle.emit(1));
+
+    e->add_handler<int>("EVENT_NAME", [&payload, &sync](int i){ payload = -i; sync.release(); });
+    EXPECT_TRUE(handle.emit(42));
+    sync.acquire();
+    EXPECT_EQ(payload, -42);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_handle_after_restart)
+{
+    constexpr evds::event_key<std::string> key("EVENT_NAME");
+    auto handle = e->register_event(key);
+
+    e->start();
+    e->add_handler(key, [](const std::string& s){});
+    e->stop();
+    EXPECT_FALSE(handle.emit("payload")); // stop() drops every handler
+
+    e->start();
+    std::promise<std::string> promise;
+    std::future<std::string> future = promise.get_future();
+    e->add_handler(key, [&promise](const std::string& s){ promise.set_value(s); });
+    EXPECT_TRUE(handle.emit("payload"));
+    EXPECT_EQ("payload", future.get());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_batch)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start();
+
+    constexpr int total_count = 100;
+    std::atomic<int> payload_sum = 0;
+    std::atomic<int> call_count = 0;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+
+    for (int h = 0; h < 2; ++h)
+    {
+        e->add_handler<int>(event_name, [&payload_sum, &call_count, &promise](int i)
+        {
+            payload_sum += i;
+            if(++call_count == 2 * total_count)
+                promise.set_value();
+        });
+    }
+
+    std::vector<int> payloads(total_count);
+    std::iota(payloads.begin(), payloads.end(), 1);
+    EXPECT_FALSE(e->emit_batch("OTHER_EVENT_NAME", payloads));
+    EXPECT_TRUE(e->emit_batch(event_name, payloads));
+
+    future.wait();
+    EXPECT_EQ(payload_sum, 2 * total_count * (total_count + 1) / 2);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_batch_multiple_arguments)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start();
+
+    std::atomic<int> call_count = 0;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    e->add_handler<std::string, int>(event_name, [&call_count, &promise](const std::string& s, int i)
+    {
+        EXPECT_EQ(s, std::to_string(i));
+        if(++call_count == 3)
+            promise.set_value();
+    });
+
+    const std::vector<std::tuple<std::string, int>> payloads = {{"1", 1}, {"2", 2}, {"3", 3}};
+    EXPECT_TRUE((e->emit_batch<std::string, int>(event_name, payloads)));
+
+    future.wait();
+    EXPECT_EQ(call_count, 3);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_scoped_batch)
+{
+    e->start();
+
+    std::atomic<int> call_count = 0;
+    std::counting_semaphore<3> sync(0);
+    e->add_handler<int>("EVENT_A", [&call_count, &sync](int i){ call_count += i; sync.release(); });
+    e->add_handler<std::string>("EVENT_B", [&call_count, &sync](const std::string& s){ call_count += 100; sync.release(); });
+
+    {
+        evds::event_dispatcher::batch batch(*e);
+        EXPECT_TRUE(batch.emit("EVENT_A", 1));
+        EXPECT_TRUE(batch.emit<"EVENT_B">(std::string("payload")));
+        EXPECT_TRUE(batch.emit("EVENT_A", 2));
+        EXPECT_FALSE(batch.emit("EVENT_C"));
+        EXPECT_EQ(call_count, 0); // nothing is enqueued before the batch is submitted
+    }
+
+    for (int i = 0; i < 3; ++i)
+        sync.acquire();
+    EXPECT_EQ(call_count, 103);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_fan_out)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start();
+    evds::event_options event_options;
+    event_options.dispatch = evds::dispatch_mode::fan_out;
+    e->configure_event<std::string>(event_name, event_options);
+
+    constexpr int handlers_count = 5;
+    std::vector<std::thread::id> thread_ids;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    for (int h = 0; h < handlers_count; ++h)
+    {
+        e->add_handler<std::string>(event_name, [&thread_ids, &promise](const std::string& s)
+        {
+            EXPECT_EQ(s, "payload");
+            thread_ids.push_back(std::this_thread::get_id()); // handlers never overlap in fan_out mode
+            if(thread_ids.size() == handlers_count)
+                promise.set_value();
+        });
+    }
+
+    EXPECT_TRUE(e->emit(event_name, std::string("payload")));
+    future.wait();
+    EXPECT_EQ(std::count(thread_ids.begin(), thread_ids.end(), thread_ids.front()), handlers_count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_chunked)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start(2);
+    evds::event_options event_options;
+    event_options.dispatch = evds::dispatch_mode::chunked;
+    event_options.chunk_size = 2;
+    e->configure_event<std::string>(event_name, event_options);
+
+    constexpr int handlers_count = 5;
+    constexpr int total_count = 10;
+    std::atomic<int> call_count = 0;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    for (int h = 0; h < handlers_count; ++h)
+    {
+        e->add_handler<std::string>(event_name, [&call_count, &promise](const std::string& s)
+        {
+            EXPECT_EQ(s, "payload");
+            if(++call_count == handlers_count * total_count)
+                promise.set_value();
+        });
+    }
+
+    for (int i = 0; i < total_count; ++i)
+    {
+        EXPECT_TRUE(e->emit(event_name, std::string("payload")));
+    }
+
+    future.wait();
+    EXPECT_EQ(call_count, handlers_count * total_count);
+}
+
+struct copy_counter
+{
+    copy_counter(int value, std::atomic<int>& copies) : value{value}, copies{&copies} {}
+    copy_counter(const copy_counter& other) : value{other.value}, copies{other.copies} { ++*copies; }
+    copy_counter(copy_counter&& other) noexcept = default;
+    copy_counter& operator=(const copy_counter&) = delete;
+    copy_counter& operator=(copy_counter&&) = delete;
+
+    int value;
+    std::atomic<int>* copies;
+};
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_shared_payload)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start();
+
+    constexpr int handlers_count = 3;
+    std::atomic<int> copies = 0;
+    std::atomic<int> payload_sum = 0;
+    std::counting_semaphore<handlers_count> sync(0);
+    for (int h = 0; h < handlers_count; ++h)
+    {
+        e->add_handler<copy_counter>(event_name, [&payload_sum, &sync](const copy_counter& c)
+        {
+            payload_sum += c.value;
+            sync.release();
+        });
+    }
+
+    EXPECT_TRUE(e->emit(event_name, copy_counter(1, copies)));
+    for (int h = 0; h < handlers_count; ++h)
+        sync.acquire();
+
+    EXPECT_TRUE(e->emplace_emit<copy_counter>(event_name, 2, copies));
+    for (int h = 0; h < handlers_count; ++h)
+        sync.acquire();
+
+    EXPECT_EQ(payload_sum, handlers_count * 3);
+    EXPECT_EQ(copies, 0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_mutable_reference_handler)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start();
+    evds::event_options event_options;
+    event_options.dispatch = evds::dispatch_mode::fan_out;
+    e->configure_event<std::string>(event_name, event_options);
+
+    std::vector<std::string> received;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    e->add_handler<std::string&>(event_name, [&received](std::string& s){ s += "_modified"; received.push_back(s); });
+    e->add_handler<std::string&&>(event_name, [&received](std::string&& s){ received.push_back(std::move(s)); });
+    e->add_handler<std::string>(event_name, [&received, &promise](const std::string& s){ received.push_back(s); promise.set_value(); });
+
+    EXPECT_TRUE(e->emit(event_name, std::string("payload")));
+    future.wait();
+    EXPECT_EQ(received, (std::vector<std::string>{"payload_modified", "payload", "payload"}));
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, add_and_remove_handlers_while_emitting)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start();
+
+    constexpr int total_count = 1000;
+    std::atomic<int> call_count = 0;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    e->add_handler<int>(event_name, [&call_count, &promise](int)
+    { 
+        if(++call_count == total_count)
+            promise.set_value();
+    });
+
+    std::atomic_bool is_emitting = true;
+    std::thread producer([this, event_name, &is_emitting]
+    {
+        for (int i = 0; i < total_count; ++i)
+            EXPECT_TRUE(e->emit(event_name, i));
+        is_emitting = false;
+    });
+
+    while (is_emitting)
+    {
+        const auto handler_id = e->add_handler<int>(event_name, [](int){});
+        EXPECT_TRUE(e->remove_handler(handler_id));
+    }
+
+    producer.join();
+    future.wait();
+    EXPECT_EQ(call_count, total_count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, register_events_while_emitting)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start();
+
+    constexpr int total_count = 1000;
+    std::atomic<int> call_count = 0;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    auto event = e->register_event<int>(event_name);
+    e->add_handler<int>(event_name, [&call_count, &promise](int)
+    { 
+        if(++call_count == total_count)
+            promise.set_value();
+    });
+
+    std::thread producer([&event]
+    {
+        for (int i = 0; i < total_count; ++i)
+            EXPECT_TRUE(event.emit(i));
+    });
+
+    for (int i = 0; i < 100; ++i)
+        e->configure_event<double>("EVENT_" + std::to_string(i), {});
+
+    producer.join();
+    future.wait();
+    EXPECT_EQ(call_count, total_count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, emit_sync_not_started)
+{
+    const auto event_name = "EVENT_NAME";
+    int inline_value = 0;
+    std::atomic<int> queued_value = 0;
+    evds::handler_options handler_options;
+    handler_options.inline_safe = true;
+    e->add_handler<int>(event_name, [&inline_value](int i){ inline_value = i; }, handler_options);
+    e->add_handler<int>(event_name, [&queued_value](int i){ queued_value = i; });
+
+    EXPECT_TRUE(e->emit_sync(event_name, 42));
+    EXPECT_EQ(inline_value, 42);
+    EXPECT_EQ(queued_value, 0);
+    EXPECT_FALSE(e->emit_sync(event_name, 1.0));
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, emit_sync_mixed_handlers)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start();
+
+    std::thread::id inline_thread;
+    std::promise<std::thread::id> promise;
+    std::future<std::thread::id> future = promise.get_future();
+    evds::handler_options handler_options;
+    handler_options.inline_safe = true;
+    e->add_handler<std::string>(event_name, [&inline_thread](const std::string& s)
+    { 
+        EXPECT_EQ(s, "payload");
+        inline_thread = std::this_thread::get_id(); 
+    }, handler_options);
+    e->add_handler<std::string>(event_name, [&promise](const std::string& s)
+    { 
+        EXPECT_EQ(s, "payload");
+        promise.set_value(std::this_thread::get_id()); 
+    });
+
+    EXPECT_TRUE(e->emit_sync(event_name, std::string("payload")));
+    EXPECT_EQ(inline_thread, std::this_thread::get_id());
+    EXPECT_NE(future.get(), std::this_thread::get_id());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, emit_sync_event_handle)
+{
+    constexpr evds::event_key<int> key{"EVENT_NAME"};
+    int value = 0;
+    evds::handler_options handler_options;
+    handler_options.inline_safe = true;
+    e->add_handler(key, [&value](int i){ value += i; }, handler_options);
+
+    auto event = e->register_event(key);
+    EXPECT_TRUE(event.emit_sync(1));
+    EXPECT_TRUE(e->emit_sync(key, 2));
+    EXPECT_TRUE(e->emit_sync<"EVENT_NAME">(3));
+    EXPECT_EQ(value, 6);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, removed_handler_skips_queued_events)
+{
+    const auto event_name = "EVENT_NAME";
+    std::atomic<int> removed_count = 0;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    const auto handler_id = e->add_handler<int>(event_name, [&removed_count](int){ ++removed_count; });
+    e->add_handler<int>(event_name, [&promise](int){ promise.set_value(); });
+
+    EXPECT_TRUE(e->emit(event_name, 1));
+    EXPECT_TRUE(e->remove_handler(handler_id));
+    e->start();
+
+    future.wait();
+    EXPECT_EQ(removed_count, 0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_priority)
+{
+    std::vector<std::string> calls;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    e->add_handler<int>("LOW", [&calls](int){ calls.push_back("LOW"); });
+    e->add_handler<int>("HIGH", [&calls](int){ calls.push_back("HIGH"); });
+    e->add_handler<>("DONE", [&promise](){ promise.set_value(); });
+
+    for (int i = 0; i < 3; ++i)
+        EXPECT_TRUE(e->emit(evds::event_priority::low, "LOW", i));
+    EXPECT_TRUE(e->emit(evds::event_priority::high, "HIGH", 0));
+    EXPECT_TRUE(e->emit(evds::event_priority::low, "DONE"));
+
+    e->start();
+    future.wait();
+    EXPECT_EQ(calls, (std::vector<std::string>{"HIGH", "LOW", "LOW", "LOW"}));
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_default_priority)
+{
+    constexpr evds::event_key<> heartbeat{"HEARTBEAT"};
+    std::vector<std::string> calls;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    evds::event_options event_options;
+    event_options.priority = evds::event_priority::high;
+    e->configure_event(heartbeat, event_options);
+    e->add_handler(heartbeat, [&calls](){ calls.push_back("HEARTBEAT"); });
+    e->add_handler<int>("TELEMETRY", [&calls](int){ calls.push_back("TELEMETRY"); });
+    e->add_handler<>("DONE", [&promise](){ promise.set_value(); });
+
+    EXPECT_TRUE(e->emit("TELEMETRY", 1));
+    EXPECT_TRUE(e->emit("TELEMETRY", 2));
+    EXPECT_TRUE(e->emit(heartbeat));
+    EXPECT_TRUE(e->emit("DONE"));
+
+    EXPECT_EQ(e->queue_depth(evds::event_priority::high), 1);
+    EXPECT_EQ(e->queue_depth(evds::event_priority::normal), 3);
+    EXPECT_EQ(e->queue_depth(evds::event_priority::low), 0);
+
+    e->start();
+    future.wait();
+    EXPECT_EQ(calls, (std::vector<std::string>{"HEARTBEAT", "TELEMETRY", "TELEMETRY"}));
+    EXPECT_EQ(e->queue_depth(evds::event_priority::high), 0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_weighted_priority)
+{
+    e = std::make_unique<evds::event_dispatcher>(evds::dispatcher_options{
+        .scheduling = evds::lane_scheduling::weighted, 
+        .lane_weights = {2, 1, 1}});
+
+    std::string calls;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    e->add_handler<char>("EVENT_NAME", [&calls, &promise](char c)
+    {
+        calls.push_back(c);
+        if (calls.size() == 8)
+            promise.set_value();
+    });
+
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(e->emit(evds::event_priority::high, "EVENT_NAME", 'H'));
+        EXPECT_TRUE(e->emit(evds::event_priority::low, "EVENT_NAME", 'L'));
+    }
+
+    e->start();
+    future.wait();
+    EXPECT_EQ(calls, "HHLHHLLL");
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, try_emit_overflow_policies)
+{
+    const auto event_name = "EVENT_NAME";
+    for (const auto overflow : {evds::overflow_policy::drop_newest, evds::overflow_policy::reject, evds::overflow_policy::block})
+    {
+        evds::dispatcher_options options;
+        options.lane_capacity = 2;
+        options.overflow = overflow;
+        e = std::make_unique<evds::event_dispatcher>(options);
+        EXPECT_EQ(e->try_emit(event_name, 0), evds::emit_status::no_handlers);
+
+        e->add_handler<int>(event_name, [](int){});
+        EXPECT_EQ(e->try_emit(event_name, 1), evds::emit_status::queued);
+        EXPECT_EQ(e->try_emit(event_name, 2), evds::emit_status::queued);
+
+        const auto expected_status = overflow == evds::overflow_policy::drop_newest ? evds::emit_status::dropped : evds::emit_status::rejected;
+        EXPECT_EQ(e->try_emit(event_name, 3), expected_status);
+        EXPECT_EQ(e->queue_depth(evds::event_priority::normal), 2);
+    }
+
+    const auto stats = e->overflow_stats();
+    EXPECT_EQ(stats.rejected, 1);
+    EXPECT_EQ(stats.dropped_newest, 0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_drop_oldest)
+{
+    evds::dispatcher_options options;
+    options.lane_capacity = 3;
+    options.overflow = evds::overflow_policy::drop_oldest;
+    e = std::make_unique<evds::event_dispatcher>(options);
+
+    std::vector<int> calls;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    e->add_handler<int>("EVENT_NAME", [&calls, &promise](int i)
+    { 
+        calls.push_back(i);
+        if (i == 9)
+            promise.set_value();
+    });
+
+    for (int i = 0; i < 10; ++i)
+        EXPECT_TRUE(e->emit("EVENT_NAME", i));
+
+    EXPECT_EQ(e->queue_depth(evds::event_priority::normal), 3);
+    EXPECT_EQ(e->overflow_stats().dropped_oldest, 7);
+
+    e->start();
+    future.wait();
+    EXPECT_EQ(calls, (std::vector<int>{7, 8, 9}));
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_block_until_room)
+{
+    using namespace std::chrono_literals;
+    e = std::make_unique<evds::event_dispatcher>(evds::dispatcher_options{
+        .lane_capacity = 1, 
+        .overflow = evds::overflow_policy::block, 
+        .block_timeout = 10ms});
+
+    std::atomic<int> call_count = 0;
+    e->add_handler<int>("EVENT_NAME", [](int){});
+
+    EXPECT_TRUE(e->emit("EVENT_NAME", 1));
+    EXPECT_FALSE(e->emit("EVENT_NAME", 2)); // nobody pops: times out
+    EXPECT_EQ(e->overflow_stats().timed_out, 1);
+
+    e = std::make_unique<evds::event_dispatcher>(evds::dispatcher_options{
+        .lane_capacity = 1, 
+        .overflow = evds::overflow_policy::block, 
+        .block_timeout = 10s});
+    e->add_handler<int>("EVENT_NAME", [&call_count](int){ ++call_count; });
+    e->start();
+
+    for (int i = 0; i < 100; ++i)
+        EXPECT_TRUE(e->emit("EVENT_NAME", i));
+
+    while (call_count < 100)
+        std::this_thread::yield();
+    EXPECT_EQ(e->overflow_stats().timed_out, 0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_ordered)
+{
+    const auto event_name = "EVENT_NAME";
+    evds::event_options event_options;
+    event_options.ordered = true;
+    e->configure_event<int>(event_name, event_options);
+    e->start(4);
+
+    constexpr int total_count = 1000;
+    std::atomic<int> in_flight = 0;
+    int last_value = -1;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    e->add_handler<int>(event_name, [&in_flight, &last_value, &promise](int i)
+    {
+        EXPECT_EQ(++in_flight, 1);
+        EXPECT_EQ(last_value + 1, i);
+        last_value = i;
+        --in_flight;
+        if (i == total_count - 1)
+            promise.set_value();
+    });
+
+    for (int i = 0; i < total_count; ++i)
+        EXPECT_TRUE(e->emit(event_name, i));
+
+    future.wait();
+    EXPECT_EQ(last_value, total_count - 1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_strand_key)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start(4);
+
+    constexpr int keys_count = 4;
+    constexpr int total_count = 250;
+    std::array<int, keys_count> last_values;
+    last_values.fill(-1);
+    std::atomic<int> call_count = 0;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    e->add_handler<int, int>(event_name, [&last_values, &call_count, &promise](int key, int i)
+    {
+        EXPECT_EQ(last_values[key] + 1, i);
+        last_values[key] = i;
+        if (++call_count == keys_count * total_count)
+            promise.set_value();
+    });
+
+    for (int i = 0; i < total_count; ++i)
+    {
+        for (int key = 0; key < keys_count; ++key)
+            EXPECT_TRUE(e->emit(evds::strand_key{static_cast<std::uint64_t>(key)}, event_name, key, i));
+    }
+
+    future.wait();
+    for (int key = 0; key < keys_count; ++key)
+        EXPECT_EQ(last_values[key], total_count - 1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_strand_keys_run_in_parallel)
+{
+    const auto event_name = "EVENT_NAME";
+    evds::thread_pool pool{2}; // start(2) runs a single thread on a single CPU
+    e->start(pool, 2);
+
+    // Keys 1 and 60 share a stripe of strands: the first handler only returns once the second one ran.
+    std::promise<void> promise;
+    std::shared_future<void> future = promise.get_future().share();
+    std::atomic<bool> is_blocked = false;
+    e->add_handler<std::uint64_t>(event_name, [&promise, future, &is_blocked](std::uint64_t key)
+    {
+        if (key == 60)
+            promise.set_value();
+        else
+            is_blocked = future.wait_for(std::chrono::seconds(5)) != std::future_status::ready;
+    });
+
+    EXPECT_TRUE(e->emit(evds::strand_key{1}, event_name, std::uint64_t{1}));
+    EXPECT_TRUE(e->emit(evds::strand_key{60}, event_name, std::uint64_t{60}));
+
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+    EXPECT_FALSE(is_blocked);
+    e->stop();
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, push_event_ordered_batch)
+{
+    const auto event_name = "EVENT_NAME";
+    evds::event_options event_options;
+    event_options.ordered = true;
+    e->configure_event<int>(event_name, event_options);
+
+    std::vector<int> calls;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    e->add_handler<int>(event_name, [&calls, &promise](int i)
+    {
+        calls.push_back(i);
+        if (i == 5)
+            promise.set_value();
+    });
+
+    {
+        evds::event_dispatcher::batch batch(*e);
+        for (int i = 0; i < 3; ++i)
+            EXPECT_TRUE(batch.emit(event_name, i));
+    }
+    EXPECT_TRUE(e->emit_batch(event_name, std::vector<int>{3, 4, 5}));
+
+    e->start(4);
+    future.wait();
+    EXPECT_EQ(calls, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, emit_batch_respects_lane_capacity)
+{
+    const auto event_name = "EVENT_NAME";
+    for (const auto [policy, expected] : {std::pair{evds::overflow_policy::drop_newest, std::vector<int>{0, 1, 2, 3}},
+                                          std::pair{evds::overflow_policy::drop_oldest, std::vector<int>{6, 7, 8, 9}},
+                                          std::pair{evds::overflow_policy::reject, std::vector<int>{0, 1, 2, 3}}})
+    {
+        evds::dispatcher_options options;
+        options.lane_capacity = 4;
+        options.overflow = policy;
+        e = std::make_unique<evds::event_dispatcher>(options);
+
+        std::vector<int> values;
+        e->add_handler<int>(event_name, [&values](int value){ values.push_back(value); });
+
+        // With drop_oldest every payload is queued, older ones are evicted instead.
+        EXPECT_EQ(e->emit_batch(event_name, std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), policy == evds::overflow_policy::drop_oldest);
+        EXPECT_EQ(e->queue_depth(evds::event_priority::normal), 4);
+
+        e->start();
+        EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+        EXPECT_EQ(values, expected);
+    }
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, ordered_batch_is_admitted)
+{
+    evds::dispatcher_options options;
+    options.lane_capacity = 1;
+    options.overflow = evds::overflow_policy::drop_newest;
+    e = std::make_unique<evds::event_dispatcher>(options);
+
+    const auto event_name = "EVENT_NAME";
+    evds::event_options event_options;
+    event_options.ordered = true;
+    e->configure_event<int>(event_name, event_options);
+    std::atomic<int> call_count = 0;
+    e->add_handler<int>(event_name, [&call_count](int){ ++call_count; });
+
+    // The first ordered emit fills the lane: the whole batch is dropped on submit.
+    EXPECT_TRUE(e->emit(event_name, 0));
+    {
+        evds::event_dispatcher::batch batch(*e);
+        for (int i = 1; i < 4; ++i)
+            EXPECT_TRUE(batch.emit(event_name, i));
+    }
+    EXPECT_EQ(e->queue_depth(evds::event_priority::normal), 1);
+    EXPECT_EQ(e->overflow_stats().dropped_newest, 1);
+
+    e->start();
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+    EXPECT_EQ(call_count, 1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, start_pinned_threads)
+{
+    evds::start_options options;
+    options.threads = 1;
+    options.cpu_sets = {{0}};
+    options.thread_name = "evds_test";
+    EXPECT_TRUE(e->start(options));
+#if defined(__linux__)
+    EXPECT_EQ(e->pinned_threads(), 1);
+#endif
+
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    e->add_handler<>("EVENT_NAME", [&promise](){ promise.set_value(); });
+    EXPECT_TRUE(e->emit("EVENT_NAME"));
+    future.wait();
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, start_pinned_threads_fallback)
+{
+    evds::start_options options;
+    options.threads = 1;
+    options.cpu_sets = {{1u << 20}};
+    EXPECT_TRUE(e->start(options));
+    EXPECT_EQ(e->pinned_threads(), 0);
+
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    e->add_handler<>("EVENT_NAME", [&promise](){ promise.set_value(); });
+    EXPECT_TRUE(e->emit("EVENT_NAME"));
+    future.wait();
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, wait_strategies)
+{
+    const auto event_name = "EVENT_NAME";
+    constexpr int total_count = 1000;
+    std::atomic<int> call_count = 0;
+    e->add_handler<int>(event_name, [&call_count](int){ ++call_count; });
+
+    for (const auto wait : {evds::wait_strategy::blocking, evds::wait_strategy::spin_then_park, evds::wait_strategy::busy_poll})
+    {
+        call_count = 0;
+        evds::start_options options;
+        options.threads = 2;
+        options.wait = wait;
+        options.spin_iterations = 64;
+        EXPECT_TRUE(e->start(options));
+
+        for (int i = 0; i < total_count; ++i)
+        {
+            EXPECT_TRUE(e->emit(event_name, i));
+            if (i % 100 == 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+
+        while (call_count < total_count)
+            std::this_thread::yield();
+
+        EXPECT_TRUE(e->stop());
+        e->add_handler<int>(event_name, [&call_count](int){ ++call_count; });
+    }
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, elastic_pool_grow_and_shrink)
+{
+    const auto event_name = "EVENT_NAME";
+    std::atomic<int> call_count = 0;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    e->add_handler<int>(event_name, [&call_count, released](int){ released.wait(); ++call_count; });
+
+    evds::start_options options;
+    options.threads = 1;
+    options.max_threads = 4;
+    options.grow_queue_depth = 1;
+    options.grow_interval = std::chrono::milliseconds(0);
+    options.idle_timeout = std::chrono::milliseconds(20);
+    EXPECT_TRUE(e->start(options));
+    EXPECT_EQ(e->running_threads(), 1);
+
+    int emitted = 0;
+    for (; emitted < 1000 && e->running_threads() < 4; ++emitted)
+    {
+        EXPECT_TRUE(e->emit(event_name, emitted));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(e->running_threads(), 4);
+
+    release.set_value();
+    while (call_count < emitted)
+        std::this_thread::yield();
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (e->running_threads() > 1 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(e->running_threads(), 1);
+
+    EXPECT_TRUE(e->emit(event_name, 0));
+    while (call_count < emitted + 1)
+        std::this_thread::yield();
+    EXPECT_TRUE(e->stop());
+    EXPECT_EQ(e->running_threads(), 0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, elastic_pool_grows_on_sustained_backlog)
+{
+    const auto event_name = "EVENT_NAME";
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    e->add_handler<int>(event_name, [released](int){ released.wait(); });
+
+    evds::start_options options;
+    options.threads = 1;
+    options.max_threads = 4;
+    options.grow_queue_depth = 1;
+    options.grow_interval = std::chrono::milliseconds(200);
+    EXPECT_TRUE(e->start(options));
+
+    // A backlog younger than grow_interval adds no thread, whatever its depth.
+    for (int i = 0; i < 10; ++i)
+        EXPECT_TRUE(e->emit(event_name, i));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20)); // the thread is busy from here
+    EXPECT_TRUE(e->emit(event_name, 10));
+    EXPECT_EQ(e->running_threads(), 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    EXPECT_TRUE(e->emit(event_name, 11));
+    EXPECT_EQ(e->running_threads(), 2);
+
+    // The next thread needs a whole window again.
+    EXPECT_TRUE(e->emit(event_name, 12));
+    EXPECT_EQ(e->running_threads(), 2);
+
+    release.set_value();
+    EXPECT_TRUE(e->stop());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, elastic_pool_stop_while_growing)
+{
+    const auto event_name = "EVENT_NAME";
+    std::atomic<int> call_count = 0;
+    e->add_handler<int>(event_name, [&call_count](int){ std::this_thread::sleep_for(std::chrono::microseconds(50)); ++call_count; });
+
+    for (int round = 0; round < 3; ++round)
+    {
+        evds::start_options options;
+        options.threads = 1;
+        options.max_threads = 8;
+        options.grow_queue_depth = 4;
+        options.grow_interval = std::chrono::milliseconds(0);
+        EXPECT_TRUE(e->start(options));
+        for (int i = 0; i < 500; ++i)
+            EXPECT_TRUE(e->emit(event_name, i));
+        EXPECT_LE(e->running_threads(), 8);
+        EXPECT_TRUE(e->stop());
+        e->add_handler<int>(event_name, [&call_count](int){ ++call_count; });
+    }
+}
+
+// NOLINTNEXTLINE
+TEST(latency_histogram, percentile)
+{
+    evds::latency_histogram histogram;
+    EXPECT_EQ(histogram.percentile(0.5), std::chrono::nanoseconds(0));
+
+    histogram.buckets[0] = 10;
+    histogram.buckets[10] = 80;
+    histogram.buckets[20] = 10;
+    EXPECT_EQ(histogram.count(), 100);
+    EXPECT_EQ(histogram.percentile(0.05), std::chrono::nanoseconds(0));
+    EXPECT_EQ(histogram.percentile(0.5), std::chrono::nanoseconds(1 << 10));
+    EXPECT_EQ(histogram.percentile(0.99), std::chrono::nanoseconds(1 << 20));
+}
+
+#if defined(EVDS_ENABLE_STATS)
+// NOLINTNEXTLINE
+TEST_F(evds_test, stats_counters)
+{
+    const auto event_name = "EVENT_NAME";
+    constexpr int total_count = 100;
+    std::atomic<int> call_count = 0;
+    e->add_handler<int>(event_name, [&call_count](int){ ++call_count; });
+    e->add_handler<int>(event_name, [&call_count](int){ ++call_count; });
+    e->start();
+
+    for (int i = 0; i < total_count; ++i)
+        EXPECT_TRUE(e->emit(event_name, i));
+    EXPECT_FALSE(e->emit("MISSING_EVENT", 0));
+
+    while (call_count < 2 * total_count)
+        std::this_thread::yield();
+    e->stop();
+
+    const auto stats = e->stats();
+    const auto& event_stats = stats.events.at(e->get_event_handler_id<int>(event_name));
+    EXPECT_EQ(event_stats.emitted, total_count);
+    EXPECT_EQ(event_stats.dispatched, 2 * total_count);
+    EXPECT_EQ(event_stats.no_handlers, 0);
+    EXPECT_EQ(event_stats.queueing_latency.count(), 2 * total_count);
+    EXPECT_EQ(event_stats.handler_time.count(), 2 * total_count);
+
+    EXPECT_EQ(stats.total.emitted, total_count);
+    EXPECT_EQ(stats.total.no_handlers, 1);
+    EXPECT_EQ(stats.queue_depth[1], 0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, stats_dropped_and_handler_time)
+{
+    evds::dispatcher_options options;
+    options.lane_capacity = 1;
+    options.overflow = evds::overflow_policy::reject;
+    e = std::make_unique<evds::event_dispatcher>(options);
+    const auto event_name = "EVENT_NAME";
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> call_count = 0;
+    e->add_handler<int>(event_name, [&call_count, released](int)
+    {
+        released.wait();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        ++call_count;
+    });
+
+    EXPECT_TRUE(e->emit(event_name, 0));
+    EXPECT_EQ(e->try_emit(event_name, 1), evds::emit_status::rejected);
+    EXPECT_EQ(e->stats().queue_depth[1], 1);
+
+    e->start();
+    release.set_value();
+    while (call_count < 1)
+        std::this_thread::yield();
+    e->stop();
+
+    const auto stats = e->stats().events.at(e->get_event_handler_id<int>(event_name));
+    EXPECT_EQ(stats.emitted, 1);
+    EXPECT_EQ(stats.dropped, 1);
+    EXPECT_GE(stats.handler_time.percentile(0.5), std::chrono::milliseconds(2));
+}
+#endif
+
+// NOLINTNEXTLINE
+TEST(trace_buffer, keeps_last_records)
+{
+    evds::details::trace_buffer buffer("thread");
+    constexpr std::uint64_t total_count = evds::details::trace_buffer::capacity + 10;
+    for (std::uint64_t i = 1; i <= total_count; ++i)
+        buffer.push({evds::details::trace_kind::emit, 0, 0, 0, 0, i});
+
+    const auto records = buffer.records();
+    ASSERT_EQ(records.size(), evds::details::trace_buffer::capacity);
+    EXPECT_EQ(records.front().emit_id, 11);
+    EXPECT_EQ(records.back().emit_id, total_count);
+}
+
+// NOLINTNEXTLINE
+TEST(trace_log, chrome_trace_json)
+{
+    evds::details::trace_log trace;
+    trace.name_this_thread("main");
+    const auto now = std::chrono::steady_clock::now();
+    const auto emit_id = trace.record_emit(1, now);
+    trace.record_pickup(1, emit_id, now);
+    trace.record_handler(1, emit_id, 7, now, now + std::chrono::microseconds(5));
+
+    std::ostringstream out;
+    trace.write(out, [](evds::event_id_t){ return std::string_view{"A \"quoted\" name"}; });
+    const auto json = out.str();
+    EXPECT_NE(json.find(R"("name":"thread_name","pid":1,"tid":0,"args":{"name":"main"})"), std::string::npos);
+    EXPECT_NE(json.find(R"("name":"A \"quoted\" name")"), std::string::npos);
+    EXPECT_NE(json.find(R"("ph":"s","cat":"flow")"), std::string::npos);
+    EXPECT_NE(json.find(R"("ph":"f","bp":"e","cat":"flow")"), std::string::npos);
+    EXPECT_NE(json.find(R"("dur":5.000,"args":{"handler":7,"emit":1})"), std::string::npos);
+}
+
+#if defined(EVDS_ENABLE_TRACING)
+// NOLINTNEXTLINE
+TEST_F(evds_test, dump_trace)
+{
+    const auto event_name = "EVENT_NAME";
+    std::atomic<int> call_count = 0;
+    const auto id = e->add_handler<int>(event_name, [&call_count](int){ ++call_count; });
+    evds::start_options options;
+    options.threads = 1;
+    options.thread_name = "tracer";
+    e->start(options);
+
+    EXPECT_TRUE(e->emit(event_name, 0));
+    while (call_count < 1)
+        std::this_thread::yield();
+    e->stop();
+
+    std::ostringstream out;
+    e->dump_trace(out);
+    const auto json = out.str();
+    EXPECT_NE(json.find(R"("args":{"name":"tracer-0"})"), std::string::npos);
+    EXPECT_NE(json.find(R"("cat":"emit","name":"EVENT_NAME")"), std::string::npos);
+    EXPECT_NE(json.find(R"("cat":"pickup","name":"EVENT_NAME")"), std::string::npos);
+    EXPECT_NE(json.find(R"("args":{"handler":)" + std::to_string(id)), std::string::npos);
+}
+#endif
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, handler_ids_per_dispatcher)
+{
+    evds::event_dispatcher other;
+    EXPECT_EQ(e->add_handler("", [](){}), 1);
+    EXPECT_EQ(other.add_handler("", [](){}), 1);
+
+    constexpr int threads_count = 4;
+    constexpr int handlers_count = 250;
+    std::vector<std::vector<unsigned long>> ids(threads_count);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; ++t)
+    {
+        threads.emplace_back([this, &ids, t]
+        {
+            for (int i = 0; i < handlers_count; ++i)
+                ids[t].push_back(e->add_handler(std::to_string(i % 10), [](){}));
+        });
+    }
+    for (auto&& thread : threads)
+        thread.join();
+
+    std::vector<unsigned long> all_ids;
+    for (auto&& thread_ids : ids)
+        all_ids.insert(all_ids.end(), thread_ids.begin(), thread_ids.end());
+    std::sort(all_ids.begin(), all_ids.end());
+    EXPECT_EQ(std::adjacent_find(all_ids.begin(), all_ids.end()), all_ids.end());
+    EXPECT_EQ(all_ids.front(), 2);
+    EXPECT_EQ(all_ids.back(), threads_count * handlers_count + 1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, remove_handlers_tombstones)
+{
+    const auto event_name = "EVENT_NAME";
+    constexpr int handlers_count = 8;
+    std::array<std::atomic<int>, handlers_count> calls{};
+    std::vector<unsigned long> ids;
+    for (int i = 0; i < handlers_count; ++i)
+        ids.push_back(e->add_handler<int>(event_name, [&calls, i](int){ ++calls[i]; }));
+
+    EXPECT_TRUE(e->remove_handler(ids[1]));
+    EXPECT_TRUE(e->remove_handler(ids[3]));
+    EXPECT_FALSE(e->remove_handler(ids[3]));
+
+    e->start();
+    EXPECT_TRUE(e->emit(event_name, 0));
+    while (calls[7] < 1)
+        std::this_thread::yield();
+    EXPECT_EQ(calls[1], 0);
+    EXPECT_EQ(calls[3], 0);
+    EXPECT_EQ(calls[0], 1);
+
+    // Removing every handler compacts the event: emits find no handler.
+    for (int i = 0; i < handlers_count; ++i)
+        EXPECT_EQ(e->remove_handler(ids[i]), i != 1 && i != 3);
+    EXPECT_FALSE(e->emit(event_name, 0));
+    EXPECT_TRUE(e->stop());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, wait_idle)
+{
+    const auto event_name = "EVENT_NAME";
+    constexpr int total_count = 100;
+    std::atomic<int> call_count = 0;
+    e->add_handler<int>(event_name, [&call_count](int){ std::this_thread::sleep_for(std::chrono::microseconds(100)); ++call_count; });
+    evds::event_options event_options;
+    event_options.ordered = true;
+    e->configure_event<int>("ORDERED_EVENT", event_options);
+    e->add_handler<int>("ORDERED_EVENT", [&call_count](int){ ++call_count; });
+
+    EXPECT_TRUE(e->wait_idle(std::chrono::milliseconds(0)));
+    EXPECT_TRUE(e->emit(event_name, 0));
+    EXPECT_FALSE(e->wait_idle(std::chrono::milliseconds(10))); // not started
+
+    e->start(2);
+    for (int i = 1; i < total_count; ++i)
+    {
+        EXPECT_TRUE(e->emit(event_name, i));
+        EXPECT_TRUE(e->emit("ORDERED_EVENT", i));
+    }
+
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+    EXPECT_EQ(call_count, 2 * total_count - 1);
+    EXPECT_TRUE(e->wait_idle(std::chrono::milliseconds(0)));
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, stop_drain_policy)
+{
+    const auto event_name = "EVENT_NAME";
+    constexpr int total_count = 200;
+    std::atomic<int> call_count = 0;
+    e->add_handler<int>(event_name, [&call_count](int){ std::this_thread::sleep_for(std::chrono::microseconds(50)); ++call_count; });
+
+    e->start();
+    for (int i = 0; i < total_count; ++i)
+        EXPECT_TRUE(e->emit(event_name, i));
+    EXPECT_TRUE(e->stop(evds::drain_policy::drain, std::chrono::seconds(10)));
+    EXPECT_EQ(call_count, total_count);
+
+    // Past the timeout, the remaining events are discarded.
+    call_count = 0;
+    e->add_handler<int>(event_name, [&call_count](int){ std::this_thread::sleep_for(std::chrono::milliseconds(5)); ++call_count; });
+    e->start();
+    for (int i = 0; i < total_count; ++i)
+        EXPECT_TRUE(e->emit(event_name, i));
+    EXPECT_TRUE(e->stop(evds::drain_policy::drain, std::chrono::milliseconds(20)));
+    EXPECT_LT(call_count, total_count);
+    EXPECT_TRUE(e->wait_idle(std::chrono::milliseconds(0)));
+}
+
+auto wait_for_tick(evds::event_dispatcher& e, std::atomic<int>& resumed) -> evds::task
+{
+    const int tick = co_await e.next<int>("TICK");
+    resumed += tick;
+}
+
+auto request_reply(evds::event_dispatcher& e, int request, std::atomic<int>& reply) -> evds::task
+{
+    const auto [code, text] = co_await e.next<int, std::string>("REPLY");
+    reply = request + code + static_cast<int>(text.size());
+}
+
+auto throwing_task() -> evds::task
+{
+    throw std::runtime_error("error");
+    co_return;
+}
+
+auto awaiting_task(bool& has_thrown) -> evds::task
+{
+    try
+    {
+        co_await throwing_task();
+    }
+    catch (const std::runtime_error&)
+    {
+        has_thrown = true;
+    }
+}
+
+// Counts the frames it is part of that get destroyed.
+struct frame_guard
+{
+    ~frame_guard()
+    {
+        ++destroyed;
+    }
+
+    std::atomic<int>& destroyed;
+};
+
+auto guarded_wait_for_tick(evds::event_dispatcher& e, std::atomic<int>& resumed, std::atomic<int>& destroyed) -> evds::task
+{
+    frame_guard guard{destroyed};
+    co_await wait_for_tick(e, resumed);
+}
+
+// NOLINTNEXTLINE
+TEST(task, propagates_exceptions)
+{
+    bool has_thrown = false;
+    awaiting_task(has_thrown).start();
+    EXPECT_TRUE(has_thrown);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, await_next_event)
+{
+    constexpr int waiters_count = 2000;
+    std::atomic<int> resumed = 0;
+    e->start();
+
+    // Suspended coroutines hold no thread: thousands of them wait on a single dispatcher thread.
+    for (int i = 0; i < waiters_count; ++i)
+        wait_for_tick(*e, resumed).start();
+    EXPECT_EQ(resumed, 0);
+
+    EXPECT_TRUE(e->emit("TICK", 1));
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+    EXPECT_EQ(resumed, waiters_count);
+
+    // Each waiter is resumed once.
+    EXPECT_TRUE(e->emit("TICK", 1));
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+    EXPECT_EQ(resumed, waiters_count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, async_handler)
+{
+    std::atomic<int> reply = 0;
+    e->add_handler<int>("REQUEST", [this, &reply](int request){ return request_reply(*e, request, reply); });
+    e->start();
+
+    EXPECT_TRUE(e->emit("REQUEST", 100));
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+    EXPECT_EQ(reply, 0);
+
+    EXPECT_TRUE(e->emit("REPLY", 20, std::string("abc")));
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+    EXPECT_EQ(reply, 123);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, stop_destroys_waiting_coroutines)
+{
+    std::atomic<int> resumed = 0;
+    std::atomic<int> destroyed = 0;
+    e->start();
+    guarded_wait_for_tick(*e, resumed, destroyed).start();
+    guarded_wait_for_tick(*e, resumed, destroyed).start();
+    EXPECT_EQ(destroyed, 0);
+
+    EXPECT_TRUE(e->stop());
+    EXPECT_EQ(resumed, 0);
+    EXPECT_EQ(destroyed, 2);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, destructor_destroys_waiting_coroutines)
+{
+    std::atomic<int> resumed = 0;
+    std::atomic<int> destroyed = 0;
+    guarded_wait_for_tick(*e, resumed, destroyed).start();
+    EXPECT_FALSE(e->stop());
+    EXPECT_EQ(destroyed, 0);
+
+    e.reset();
+    EXPECT_EQ(resumed, 0);
+    EXPECT_EQ(destroyed, 1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, stop_destroys_coroutines_pending_resume)
+{
+    std::atomic<int> resumed = 0;
+    std::atomic<int> destroyed = 0;
+    std::promise<void> entered;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    evds::event_options event_options;
+    event_options.dispatch = evds::dispatch_mode::fan_out;
+    e->configure_event<int>("TICK", event_options);
+    e->start();
+    guarded_wait_for_tick(*e, resumed, destroyed).start();
+
+    // The awaiter handler registered by next() queues the resume task, then the second handler blocks the only thread.
+    e->add_handler<int>("TICK", [&entered, released](int){ entered.set_value(); released.wait(); });
+    EXPECT_TRUE(e->emit("TICK", 1));
+    entered.get_future().wait();
+
+    std::thread stopping([this]{ EXPECT_TRUE(e->stop()); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    release.set_value();
+    stopping.join();
+    EXPECT_EQ(resumed, 0);
+    EXPECT_EQ(destroyed, 1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, drop_oldest_keeps_internal_tasks)
+{
+    evds::dispatcher_options options;
+    options.lane_capacity = 1;
+    options.overflow = evds::overflow_policy::drop_oldest;
+    e = std::make_unique<evds::event_dispatcher>(options);
+
+    std::atomic<int> resumed = 0;
+    std::atomic<int> price = 0;
+    std::vector<int> others;
+    evds::event_options price_options;
+    price_options.conflate = evds::conflation::latest;
+    e->configure_event<int>("PRICE", price_options);
+    e->add_handler<int>("PRICE", [&price](int value){ price = value; });
+    e->add_handler<int>("OTHER", [&others](int i){ others.push_back(i); });
+
+    // The awaiter handler registered by next() runs first and queues the coroutine resume, then the events
+    // emitted by the second handler overflow the lane.
+    evds::event_options event_options;
+    event_options.dispatch = evds::dispatch_mode::fan_out;
+    e->configure_event<int>("TICK", event_options);
+    wait_for_tick(*e, resumed).start();
+    e->add_handler<int>("TICK", [this](int)
+    {
+        EXPECT_TRUE(e->emit("OTHER", 1));
+        EXPECT_TRUE(e->emit("OTHER", 2));
+    });
+
+    // The conflation flush task is queued first: evictions skip it.
+    EXPECT_TRUE(e->emit("PRICE", 7));
+    EXPECT_TRUE(e->emit("OTHER", 0));
+    EXPECT_TRUE(e->emit("TICK", 1));
+    EXPECT_EQ(e->queue_depth(evds::event_priority::normal), 1);
+
+    e->start();
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+    EXPECT_EQ(price, 7);
+    EXPECT_EQ(resumed, 1);
+    EXPECT_EQ(others, (std::vector<int>{2}));
+    EXPECT_EQ(e->overflow_stats().dropped_oldest, 2);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, drop_oldest_counts_strand_tasks)
+{
+    evds::dispatcher_options options;
+    options.lane_capacity = 2;
+    options.overflow = evds::overflow_policy::drop_oldest;
+    e = std::make_unique<evds::event_dispatcher>(options);
+
+    std::atomic<int> ordered_calls = 0;
+    std::atomic<int> other_calls = 0;
+    evds::event_options event_options;
+    event_options.ordered = true;
+    e->configure_event<int>("ORDERED", event_options);
+    e->add_handler<int>("ORDERED", [&ordered_calls](int){ ++ordered_calls; });
+    e->add_handler<int>("OTHER", [&other_calls](int){ ++other_calls; });
+
+    // The ordered event waits in its strand, only its drain task is in the lane: it still holds one slot.
+    EXPECT_TRUE(e->emit("ORDERED", 0));
+    EXPECT_TRUE(e->emit("OTHER", 1));
+    EXPECT_TRUE(e->emit("OTHER", 2));
+    EXPECT_EQ(e->queue_depth(evds::event_priority::normal), 2);
+
+    e->start();
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+    EXPECT_EQ(ordered_calls, 1);
+    EXPECT_EQ(other_calls, 1);
+    EXPECT_EQ(e->overflow_stats().dropped_oldest, 1);
+
+    // A lane filled by strand tasks alone has nothing to evict: the new event is dropped.
+    e = std::make_unique<evds::event_dispatcher>(options);
+    e->configure_event<int>("ORDERED", event_options);
+    e->add_handler<int>("ORDERED", [&ordered_calls](int){ ++ordered_calls; });
+    e->add_handler<int>("OTHER", [&other_calls](int){ ++other_calls; });
+    EXPECT_TRUE(e->emit("ORDERED", 1));
+    EXPECT_TRUE(e->emit("ORDERED", 2));
+    EXPECT_EQ(e->try_emit("OTHER", 3), evds::emit_status::dropped);
+    EXPECT_EQ(e->overflow_stats().dropped_newest, 1);
+    e->start();
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+    EXPECT_EQ(ordered_calls, 3);
+    EXPECT_EQ(other_calls, 1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_lock_free_test, push_event_more_than_capacity)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start();
+
+    constexpr int total_count = 1000;
+    std::atomic<int> call_count = 0;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+
+    e->add_handler<int>(event_name, [&call_count, &promise](int i)
+    {
+        if(++call_count == total_count)
+            promise.set_value();
+    });
+
+    for (int i = 0; i < total_count; ++i)
+    {
+        EXPECT_TRUE(e->emit(event_name, i));
+    }
+
+    future.wait();
+    EXPECT_EQ(call_count, total_count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_lock_free_test, push_event_from_handler_more_than_capacity)
+{
+    const auto event_name = "EVENT_NAME";
+    constexpr int total_count = 32; // twice the ring capacity
+    std::atomic<int> call_count = 0;
+    e->add_handler<int>(event_name, [&call_count](int){ ++call_count; });
+    e->add_handler<>("FAN_OUT", [this, event_name]
+    {
+        // The only dispatcher thread is the producer: nothing pops until the handler returns.
+        for (int i = 0; i < total_count; ++i)
+            EXPECT_TRUE(e->emit(event_name, i));
+    });
+
+    e->start(1);
+    EXPECT_TRUE(e->emit("FAN_OUT"));
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+    EXPECT_EQ(call_count, total_count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_lock_free_test, push_event_multiple_producers)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start(2);
+
+    constexpr int producers_count = 4;
+    constexpr int events_per_producer = 500;
+    std::atomic<long> payload_sum = 0;
+    std::atomic<int> call_count = 0;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+
+    e->add_handler<int>(event_name, [&payload_sum, &call_count, &promise](int i)
+    {
+        payload_sum += i;
+        if(++call_count == producers_count * events_per_producer)
+            promise.set_value();
+    });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producers_count; ++p)
+    {
+        producers.emplace_back([this, event_name]
+        {
+            for (int i = 1; i <= events_per_producer; ++i)
+                e->emit(event_name, i);
+        });
+    }
+
+    for (auto&& p : producers)
+        p.join();
+
+    future.wait();
+    EXPECT_EQ(payload_sum, producers_count * (events_per_producer * (events_per_producer + 1) / 2));
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_work_stealing_test, push_event_before_start)
+{
+    const auto event_name = "EVENT_NAME";
+
+    std::promise<int> promise;
+    std::future<int> future = promise.get_future();
+    e->add_handler<int>(event_name, [&promise](int i){ promise.set_value(i); });
+
+    const int expected_value = 123456789;
+    EXPECT_TRUE(e->emit(event_name, expected_value));
+
+    e->start(2);
+    EXPECT_EQ(expected_value, future.get());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_work_stealing_test, push_event_while_starting)
+{
+    const auto event_name = "EVENT_NAME";
+    constexpr int producers_count = 4;
+    constexpr int total_count = 2000;
+    std::atomic<int> call_count = 0;
+    e->add_handler<int>(event_name, [&call_count](int){ ++call_count; });
+
+    std::latch ready{producers_count + 1};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producers_count; ++p)
+    {
+        producers.emplace_back([this, &ready, event_name]
+        {
+            ready.arrive_and_wait();
+            for (int i = 0; i < total_count; ++i)
+                EXPECT_TRUE(e->emit(event_name, i));
+        });
+    }
+
+    ready.arrive_and_wait();
+    EXPECT_TRUE(e->start(4));
+    for (auto&& producer : producers)
+        producer.join();
+
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+    EXPECT_EQ(call_count, producers_count * total_count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_work_stealing_test, local_hits_and_steals_cover_all_events)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start(2);
+
+    constexpr int total_count = 1000;
+    std::atomic<int> call_count = 0;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+
+    e->add_handler<int>(event_name, [&call_count, &promise](int i)
+    {
+        if(++call_count == total_count)
+            promise.set_value();
+    });
+
+    for (int i = 0; i < total_count; ++i)
+    {
+        EXPECT_TRUE(e->emit(event_name, i));
+    }
+
+    future.wait();
+    const auto stats = e->events_queue().stats();
+    EXPECT_EQ(stats.local_hits + stats.steals, total_count);
+}
+
+// NOLINTNEXTLINE
+TEST(work_stealing_queue, workers_bound_per_queue)
+{
+    evds::details::work_stealing_queue<int> served{2};
+    evds::details::work_stealing_queue<int> other{2};
+
+    std::thread([&served, &other]
+    {
+        served.bind_worker(0);
+        EXPECT_TRUE(served.try_push(1));
+        EXPECT_TRUE(other.try_push(2));
+
+        // A worker of served is a plain producer and consumer of other: it has no deque there.
+        int item = 0;
+        EXPECT_TRUE(other.try_pop(item));
+        EXPECT_EQ(item, 2);
+        EXPECT_EQ(other.stats().local_hits + other.stats().steals, 0);
+
+        EXPECT_TRUE(served.try_pop(item));
+        EXPECT_EQ(item, 1);
+        EXPECT_EQ(served.stats().local_hits, 1);
+    }).join();
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_small_task_test, push_event_pooled_tasks)
+{
+    const auto event_name = "EVENT_NAME";
+    e->start();
+
+    constexpr int handlers_count = 3;
+    constexpr int total_count = 100;
+    std::atomic<int> call_count = 0;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    for (int h = 0; h < handlers_count; ++h)
+    {
+        e->add_handler<std::string>(event_name, [&call_count, &promise](const std::string& s)
+        {
+            EXPECT_EQ(s, "payload");
+            if(++call_count == handlers_count * total_count)
+                promise.set_value();
+        });
+    }
+
+    for (int i = 0; i < total_count; ++i)
+    {
+        EXPECT_TRUE(e->emit(event_name, std::string("payload")));
+    }
+
+    future.wait();
+    EXPECT_EQ(call_count, handlers_count * total_count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_small_task_test, push_event_oversized_payload)
+{
+    using payload_t = std::array<char, 4096>;
+    const auto event_name = "EVENT_NAME";
+    e->start();
+
+    std::promise<char> promise;
+    std::future<char> future = promise.get_future();
+    e->add_handler<payload_t>(event_name, [&promise](const payload_t& p){ promise.set_value(p.back()); });
+
+    payload_t payload{};
+    payload.back() = 'x';
+    EXPECT_TRUE(e->emit(event_name, payload));
+    EXPECT_EQ(future.get(), 'x');
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_work_stealing_test, push_event_ordered)
+{
+    const auto event_name = "EVENT_NAME";
+    evds::event_options event_options;
+    event_options.ordered = true;
+    e->configure_event<int>(event_name, event_options);
+    e->start(4);
+
+    constexpr int total_count = 1000;
+    int last_value = -1;
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    e->add_handler<int>(event_name, [&last_value, &promise](int i)
+    {
+        EXPECT_EQ(last_value + 1, i);
+        last_value = i;
+        if (i == total_count - 1)
+            promise.set_value();
+    });
+
+    for (int i = 0; i < total_count; ++i)
+        EXPECT_TRUE(e->emit(event_name, i));
+
+    future.wait();
+    EXPECT_EQ(last_value, total_count - 1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_work_stealing_test, elastic_pool)
+{
+    const auto event_name = "EVENT_NAME";
+    constexpr int total_count = 1000;
+    std::atomic<int> call_count = 0;
+    e->add_handler<int>(event_name, [&call_count](int){ std::this_thread::sleep_for(std::chrono::microseconds(10)); ++call_count; });
+
+    evds::start_options options;
+    options.threads = 1;
+    options.max_threads = 4;
+    options.grow_queue_depth = 8;
+    options.grow_interval = std::chrono::milliseconds(0);
+    EXPECT_TRUE(e->start(options));
+    for (int i = 0; i < total_count; ++i)
+        EXPECT_TRUE(e->emit(event_name, i));
+
+    while (call_count < total_count)
+        std::this_thread::yield();
+    EXPECT_TRUE(e->stop());
+}
+
+// NOLINTNEXTLINE
+TEST(timer_wheel, fires_timers_on_their_tick)
+{
+    constexpr std::size_t timers_count = 100'000;
+    evds::details::timer_wheel wheel;
+    std::mt19937_64 random{42};
+    std::vector<std::uint64_t> deadlines(timers_count);
+    std::vector<std::uint64_t> ids(timers_count);
+    std::vector<int> fire_counts(timers_count, 0);
+    std::uint64_t previous = 0;
+    std::uint64_t now = 0;
+
+    for (std::size_t i = 0; i < timers_count; ++i)
+    {
+        // Every level of the wheel, and past the top one.
+        deadlines[i] = 1 + random() % (std::uint64_t{1} << (6 * (i % 6 + 1)));
+        ids[i] = wheel.add(deadlines[i], 0, [&, i]
+        {
+            ++fire_counts[i];
+            EXPECT_GT(deadlines[i], previous);
+            EXPECT_LE(deadlines[i], now);
+        });
+    }
+
+    for (std::size_t i = 0; i < timers_count; i += 3)
+        EXPECT_TRUE(wheel.cancel(ids[i]));
+    EXPECT_FALSE(wheel.cancel(ids[0]));
+    EXPECT_EQ(wheel.size(), timers_count - (timers_count + 2) / 3);
+
+    std::vector<evds::details::timer_wheel::callback_t> due;
+    while (wheel.size() > 0)
+    {
+        previous = now;
+        now = wheel.next_tick() + random() % 100;
+        wheel.advance(now, due);
+        for (auto&& callback : due)
+            (*callback)();
+        due.clear();
+    }
+
+    for (std::size_t i = 0; i < timers_count; ++i)
+        EXPECT_EQ(fire_counts[i], i % 3 == 0 ? 0 : 1);
+    EXPECT_FALSE(wheel.cancel(ids[1]));
+    EXPECT_EQ(wheel.next_tick(), evds::details::timer_wheel::never);
+}
+
+// NOLINTNEXTLINE
+TEST(timer_wheel, periodic_timers_skip_missed_periods)
+{
+    evds::details::timer_wheel wheel;
+    int fire_count = 0;
+    const auto id = wheel.add(5, 10, [&fire_count]{ ++fire_count; });
+
+    std::vector<evds::details::timer_wheel::callback_t> due;
+    for (std::uint64_t now = 1; now <= 100; ++now)
+        wheel.advance(now, due);
+    EXPECT_EQ(due.size(), 10);
+    EXPECT_EQ(wheel.next_tick(), 105);
+
+    due.clear();
+    wheel.advance(1000, due);
+    EXPECT_EQ(due.size(), 1);
+    EXPECT_EQ(wheel.next_tick(), 1005);
+
+    EXPECT_TRUE(wheel.cancel(id));
+    EXPECT_FALSE(wheel.cancel(id));
+    EXPECT_EQ(wheel.next_tick(), evds::details::timer_wheel::never);
+}
+
+// NOLINTNEXTLINE
+TEST(timer_wheel, cancel_skips_collected_callbacks)
+{
+    evds::details::timer_wheel wheel;
+    int fire_count = 0;
+    const auto periodic = wheel.add(5, 10, [&fire_count]{ ++fire_count; });
+    const auto one_shot = wheel.add(5, 0, [&fire_count]{ ++fire_count; });
+
+    // Both are due, then cancelled before the caller of advance() runs them: only the one-shot timer has fired already.
+    std::vector<evds::details::timer_wheel::callback_t> due;
+    wheel.advance(5, due);
+    EXPECT_EQ(due.size(), 2);
+    EXPECT_TRUE(wheel.cancel(periodic));
+    EXPECT_FALSE(wheel.cancel(one_shot));
+
+    for (auto&& callback : due)
+        (*callback)();
+    EXPECT_EQ(fire_count, 1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, emit_after_and_emit_at)
+{
+    const auto event_name = "EVENT_NAME";
+    std::promise<std::chrono::steady_clock::time_point> fired;
+    std::atomic<int> call_count = 0;
+    e->add_handler<int>(event_name, [&fired, &call_count](int value)
+    {
+        ++call_count;
+        if (value == 1)
+            fired.set_value(std::chrono::steady_clock::now());
+    });
+    e->start();
+
+    const auto emitted_at = std::chrono::steady_clock::now();
+    e->emit_after(std::chrono::milliseconds(30), event_name, 1);
+    const auto cancelled = e->emit_at(emitted_at + std::chrono::milliseconds(20), event_name, 2);
+    const auto late = e->emit_after(std::chrono::hours(1), event_name, 3);
+    EXPECT_TRUE(cancelled.cancel());
+    EXPECT_FALSE(cancelled.cancel());
+
+    auto fired_at = fired.get_future();
+    ASSERT_EQ(fired_at.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_GE(fired_at.get() - emitted_at, std::chrono::milliseconds(30));
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(5)));
+    EXPECT_EQ(call_count, 1);
+
+    // Pending timers are dropped on stop.
+    EXPECT_TRUE(e->stop());
+    EXPECT_FALSE(late.cancel());
+    EXPECT_FALSE(evds::event_dispatcher::timer_handle{}.cancel());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, emit_every)
+{
+    constexpr evds::event_key<int> event{"EVENT_NAME"};
+    std::atomic<int> call_count = 0;
+    e->add_handler(event, [&call_count](int value){ EXPECT_EQ(value, 7); ++call_count; });
+    e->start();
+
+    const auto timer = e->emit_every(std::chrono::milliseconds(2), event, 7);
+    while (call_count < 5)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    EXPECT_TRUE(timer.cancel());
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(5)));
+    const int cancelled_count = call_count;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(call_count, cancelled_count);
+    EXPECT_TRUE(e->stop());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, emit_every_clamps_period)
+{
+    constexpr evds::event_key<int> event{"EVENT_NAME"};
+    std::atomic<int> call_count = 0;
+    e->add_handler(event, [&call_count](int){ ++call_count; });
+    e->start();
+
+    // A zero or negative period repeats every tick instead of firing once.
+    for (const auto period : {std::chrono::milliseconds(0), std::chrono::milliseconds(-5)})
+    {
+        call_count = 0;
+        const auto timer = e->emit_every(period, event, 7);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (call_count < 3 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        EXPECT_GE(call_count, 3);
+        EXPECT_TRUE(timer.cancel());
+    }
+    EXPECT_TRUE(e->stop());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, conflation_latest)
+{
+    const auto event_name = "PRICE";
+    evds::event_options event_options;
+    event_options.conflate = evds::conflation::latest;
+    e->configure_event<int>(event_name, event_options);
+
+    std::binary_semaphore entered{0};
+    std::binary_semaphore release{0};
+    std::vector<int> values;
+    e->add_handler<int>(event_name, [&](int value)
+    {
+        values.push_back(value);
+        if (value == 0)
+        {
+            entered.release();
+            release.acquire();
+        }
+    });
+    e->start();
+
+    // The handler is busy with the first emit: the next ones coalesce into a single queued payload.
+    EXPECT_TRUE(e->emit(event_name, 0));
+    entered.acquire();
+    for (int i = 1; i <= 100; ++i)
+        EXPECT_TRUE(e->emit(event_name, i));
+    release.release();
+
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(5)));
+    EXPECT_EQ(values, (std::vector<int>{0, 100}));
+    EXPECT_EQ(e->coalesced_emits(), 99);
+#if defined(EVDS_ENABLE_STATS)
+    EXPECT_EQ(e->stats().total.coalesced, 99);
+#endif
+    EXPECT_TRUE(e->stop());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, conflation_batch)
+{
+    const auto event_name = "PRICE";
+    evds::event_options event_options;
+    event_options.conflate = evds::conflation::latest;
+    e->configure_event<int>(event_name, event_options);
+
+    std::vector<int> values;
+    e->add_handler<int>(event_name, [&values](int value){ values.push_back(value); });
+    e->start();
+
+    {
+        evds::event_dispatcher::batch batch(*e);
+        EXPECT_TRUE(batch.emit(event_name, 1));
+        EXPECT_TRUE(batch.emit(event_name, 2));
+
+        // Nothing is delivered before submit().
+        EXPECT_TRUE(e->wait_idle(std::chrono::seconds(5)));
+        EXPECT_TRUE(values.empty());
+
+        batch.submit();
+        EXPECT_TRUE(e->wait_idle(std::chrono::seconds(5)));
+        EXPECT_FALSE(values.empty());
+        EXPECT_EQ(values.back(), 2);
+    }
+
+    // The submitted batch has nothing left to deliver on destruction.
+    const auto calls_count = values.size();
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(5)));
+    EXPECT_EQ(values.size(), calls_count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, conflation_debounce)
+{
+    const auto event_name = "SENSOR";
+    evds::event_options event_options;
+    event_options.conflate = evds::conflation::debounce;
+    event_options.conflation_window = std::chrono::milliseconds(50);
+    e->configure_event<int>(event_name, event_options);
+
+    std::atomic<int> call_count = 0;
+    std::atomic<int> last_value = 0;
+    e->add_handler<int>(event_name, [&](int value){ last_value = value; ++call_count; });
+    e->start();
+
+    const auto emitted_at = std::chrono::steady_clock::now();
+    for (int i = 1; i <= 10; ++i)
+        EXPECT_TRUE(e->emit(event_name, i));
+
+    while (call_count == 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_GE(std::chrono::steady_clock::now() - emitted_at, std::chrono::milliseconds(50));
+    EXPECT_EQ(last_value, 10);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(call_count, 1);
+    EXPECT_EQ(e->coalesced_emits(), 9);
+    EXPECT_TRUE(e->stop());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, conflation_throttle)
+{
+    const auto event_name = "SENSOR";
+    evds::event_options event_options;
+    event_options.conflate = evds::conflation::throttle;
+    event_options.conflation_window = std::chrono::milliseconds(50);
+    e->configure_event<int>(event_name, event_options);
+
+    std::mutex values_mutex;
+    std::vector<int> values;
+    e->add_handler<int>(event_name, [&](int value)
+    {
+        std::scoped_lock lock(values_mutex);
+        values.push_back(value);
+    });
+    e->start();
+
+    // The first emit goes through right away, the newest one of the window at its end.
+    EXPECT_TRUE(e->emit(event_name, 1));
+    EXPECT_TRUE(e->wait_idle(std::chrono::seconds(5)));
+    for (int i = 2; i <= 10; ++i)
+        EXPECT_TRUE(e->emit(event_name, i));
+    {
+        std::scoped_lock lock(values_mutex);
+        EXPECT_EQ(values, std::vector<int>{1});
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::scoped_lock lock(values_mutex);
+    EXPECT_EQ(values, (std::vector<int>{1, 10}));
+    EXPECT_EQ(e->coalesced_emits(), 8);
+}
+
+// Runs posted work on the thread calling run_posted(): lets tests control when dispatcher work runs.
+struct manual_executor
+{
+    void post(std::function<void()> work)
+    {
+        std::scoped_lock lock(mutex);
+        posted.push_back(std::move(work));
+    }
+
+    auto run_posted() -> std::size_t
+    {
+        std::vector<std::function<void()>> work;
+        {
+            std::scoped_lock lock(mutex);
+            work.swap(posted);
+        }
+        for (auto&& w : work)
+            w();
+        return work.size();
+    }
+
+    std::mutex mutex;
+    std::vector<std::function<void()>> posted;
+};
+
+static_assert(evds::executor<manual_executor> && !evds::timed_executor<manual_executor>);
+static_assert(evds::timed_executor<evds::thread_pool>);
+
+// NOLINTNEXTLINE
+TEST(thread_pool, post_and_post_at)
+{
+    evds::thread_pool pool{2};
+    EXPECT_EQ(pool.size(), 2);
+
+    constexpr int total_count = 1000;
+    std::latch done{total_count};
+    for (int i = 0; i < total_count; ++i)
+        pool.post([&done]{ done.count_down(); });
+    done.wait();
+
+    std::promise<std::chrono::steady_clock::time_point> ran;
+    const auto posted_at = std::chrono::steady_clock::now();
+    pool.post_at(posted_at + std::chrono::milliseconds(20), [&ran]{ ran.set_value(std::chrono::steady_clock::now()); });
+    pool.post_at(posted_at + std::chrono::hours(1), []{ FAIL(); }); // dropped by the destructor
+    EXPECT_GE(ran.get_future().get() - posted_at, std::chrono::milliseconds(20));
+}
+
+// NOLINTNEXTLINE
+TEST(thread_pool, shared_by_dispatchers)
+{
+    constexpr std::size_t dispatchers_count = 8;
+    constexpr int total_count = 1000;
+    evds::thread_pool pool{2};
+    std::vector<std::unique_ptr<evds::event_dispatcher>> dispatchers;
+    std::atomic<int> call_count = 0;
+    std::atomic<int> timer_count = 0;
+
+    for (std::size_t i = 0; i < dispatchers_count; ++i)
+    {
+        auto& e = dispatchers.emplace_back(std::make_unique<evds::event_dispatcher>());
+        e->add_handler<int>("EVENT_NAME", [&call_count](int){ ++call_count; });
+        e->add_handler("TIMER", [&timer_count]{ ++timer_count; });
+        EXPECT_TRUE(e->emit("EVENT_NAME", 0)); // queued before start
+        EXPECT_TRUE(e->start(pool, 2));
+        EXPECT_FALSE(e->start(pool));
+        EXPECT_EQ(e->running_threads(), 0);
+        e->emit_after(std::chrono::milliseconds(10), "TIMER");
+    }
+
+    for (int i = 1; i < total_count; ++i)
+    {
+        for (auto&& e : dispatchers)
+            EXPECT_TRUE(e->emit("EVENT_NAME", i));
+    }
+
+    for (auto&& e : dispatchers)
+        EXPECT_TRUE(e->wait_idle(std::chrono::seconds(10)));
+    EXPECT_EQ(call_count, dispatchers_count * total_count);
+
+    // No event is queued anymore: timers are woken up by the pool itself.
+    while (timer_count < static_cast<int>(dispatchers_count))
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    for (auto&& e : dispatchers)
+        EXPECT_TRUE(e->stop());
+}
+
+// NOLINTNEXTLINE
+TEST_F(evds_test, start_on_executor)
+{
+    manual_executor executor;
+    const auto caller_id = std::this_thread::get_id();
+    std::vector<int> values;
+    e->add_handler<int>("EVENT_NAME", [&values, caller_id](int value)
+    {
+        EXPECT_EQ(std::this_thread::get_id(), caller_id);
+        values.push_back(value);
+    });
+    EXPECT_TRUE(e->start(executor));
+
+    // A single drain is posted while it has not run, and it posts itself again after its budget.
+    for (int i = 0; i < 100; ++i)
+        EXPECT_TRUE(e->emit("EVENT_NAME", i));
+    EXPECT_EQ(executor.run_posted(), 1);
+    EXPECT_EQ(values.size(), 64);
+    EXPECT_EQ(executor.run_posted(), 1);
+    EXPECT_EQ(values.size(), 100);
+    EXPECT_EQ(executor.run_posted(), 0);
+    EXPECT_TRUE(e->wait_idle(std::chrono::milliseconds(0)));
+
+    // Work posted before stop() does nothing once run.
+    EXPECT_TRUE(e->emit("EVENT_NAME", 100));
+    EXPECT_TRUE(e->stop());
+    EXPECT_EQ(executor.run_posted(), 1);
+    EXPECT_EQ(values.size(), 100);
+}
+
+}
@@ -5,12 +5,18 @@
 
 namespace evds::tests
 {
-class event_dispatcher_test : public ::testing::Test
+template <typename QueuePolicy, std::size_t TaskSize = 48>
+class basic_event_dispatcher_test : public ::testing::Test
 {
 protected:
-    explicit event_dispatcher_test() : e { std::make_unique<evds::event_dispatcher>() } { }
-    ~event_dispatcher_test() { }
-    std::unique_ptr<evds::event_dispatcher> e;
+    explicit basic_event_dispatcher_test() : e { std::make_unique<evds::basic_event_dispatcher<QueuePolicy, TaskSize>>() } { }
+    ~basic_event_dispatcher_test() { }
+    std::unique_ptr<evds::basic_event_dispatcher<QueuePolicy, TaskSize>> e;
 };
 
+using event_dispatcher_test = basic_event_dispatcher_test<evds::queue_policy::mutex>;
+using lock_free_event_dispatcher_test = basic_event_dispatcher_test<evds::queue_policy::lock_free<16>>;
+using work_stealing_event_dispatcher_test = basic_event_dispatcher_test<evds::queue_policy::work_stealing>;
+using small_task_event_dispatcher_test = basic_event_dispatcher_test<evds::queue_policy::mutex, 16>;
+
 }